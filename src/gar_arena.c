@@ -0,0 +1,112 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include "gar_arena.h"
+#include <stdlib.h>
+#include <string.h>
+
+/******************************************************************************/
+void* gar_arena_alloc( gar_arena_t* arena, size_t size )
+{
+    void* ptr;
+    gar_arena_block_t* block = arena->current;
+    gar_arena_block_t* new_block;
+    size_t block_size;
+
+    size = ( size + GAR_ARENA_ALIGNMENT - 1 ) & ~( GAR_ARENA_ALIGNMENT - 1 );
+
+    // move on to the next block of the chain which is large enough
+    while( block != NULL && block->size - block->used < size )
+    {
+        block = block->next;
+        if( block != NULL )
+        {
+            block->used = 0;
+        }
+    }
+
+    if( block == NULL )
+    {
+        block_size = ( size > arena->block_size ) ? size : arena->block_size;
+        new_block = malloc( sizeof( gar_arena_block_t ) + block_size );
+        if( new_block == NULL )
+        {
+            return NULL;
+        }
+        new_block->size = block_size;
+        new_block->used = 0;
+
+        // insert the block after the current block to keep the blocks which
+        // were skipped for this allocation in the chain
+        if( arena->current == NULL )
+        {
+            new_block->next = NULL;
+            arena->head = new_block;
+        }
+        else
+        {
+            new_block->next = arena->current->next;
+            arena->current->next = new_block;
+        }
+        arena->block_count++;
+        block = new_block;
+    }
+
+    arena->current = block;
+    ptr = ( char* )block->data + block->used;
+    block->used += size;
+
+    return ptr;
+}
+
+/******************************************************************************/
+void gar_arena_destroy( gar_arena_t* arena )
+{
+    gar_arena_block_t* block = arena->head;
+    gar_arena_block_t* next;
+
+    while( block != NULL )
+    {
+        next = block->next;
+        free( block );
+        block = next;
+    }
+
+    gar_arena_init( arena, arena->block_size );
+}
+
+/******************************************************************************/
+void gar_arena_init( gar_arena_t* arena, size_t block_size )
+{
+    arena->head = NULL;
+    arena->current = NULL;
+    arena->block_size = block_size;
+    arena->block_count = 0;
+}
+
+/******************************************************************************/
+void gar_arena_reset( gar_arena_t* arena )
+{
+    arena->current = arena->head;
+    if( arena->head != NULL )
+    {
+        arena->head->used = 0;
+    }
+}
+
+/******************************************************************************/
+char* gar_arena_strdup( gar_arena_t* arena, const char* str )
+{
+    size_t len = strlen( str ) + 1;
+    char* copy = gar_arena_alloc( arena, len );
+
+    if( copy != NULL )
+    {
+        memcpy( copy, str, len );
+    }
+
+    return copy;
+}
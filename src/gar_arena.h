@@ -0,0 +1,108 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef GAR_ARENA_H
+#define GAR_ARENA_H
+
+#include <stddef.h>
+
+/** The default size of an arena block in bytes. */
+#define GAR_ARENA_BLOCK_SIZE 65536
+/** The alignment of all allocations in bytes. */
+#define GAR_ARENA_ALIGNMENT sizeof( double )
+
+/** A bump allocator which releases all its allocations at once. */
+typedef struct gar_arena_s gar_arena_t;
+/** A block of memory of an arena. */
+typedef struct gar_arena_block_s gar_arena_block_t;
+
+/**
+ * A block of memory of an arena. Blocks are chained and kept until the
+ * arena is destroyed.
+ */
+struct gar_arena_block_s
+{
+    /** The next block or NULL if this is the last block. */
+    gar_arena_block_t* next;
+    /** The number of usable bytes of the block. */
+    size_t size;
+    /** The number of bytes handed out from the block. */
+    size_t used;
+    /** The usable memory of the block. */
+    double data[];
+};
+
+/**
+ * A bump allocator. Allocations are served from a chain of blocks and are
+ * never released individually. A reset rewinds the arena to its first block
+ * such that the blocks are reused by the following allocations.
+ */
+struct gar_arena_s
+{
+    /** The first block of the chain or NULL if nothing was allocated yet. */
+    gar_arena_block_t* head;
+    /** The block allocations are currently served from. */
+    gar_arena_block_t* current;
+    /** The minimal size of a new block in bytes. */
+    size_t block_size;
+    /** The number of blocks in the chain. */
+    size_t block_count;
+};
+
+/**
+ * Allocate memory from the arena. The memory is aligned to
+ * GAR_ARENA_ALIGNMENT and stays valid until the arena is reset or destroyed.
+ *
+ * @param arena
+ *  A pointer to the arena.
+ * @param size
+ *  The number of bytes to allocate.
+ * @return
+ *  A pointer to the allocated memory or NULL on failure.
+ */
+void* gar_arena_alloc( gar_arena_t* arena, size_t size );
+
+/**
+ * Release all blocks of the arena.
+ *
+ * @param arena
+ *  A pointer to the arena.
+ */
+void gar_arena_destroy( gar_arena_t* arena );
+
+/**
+ * Initialise an empty arena. No memory is allocated until the first call to
+ * gar_arena_alloc().
+ *
+ * @param arena
+ *  A pointer to the arena.
+ * @param block_size
+ *  The minimal size of a block in bytes.
+ */
+void gar_arena_init( gar_arena_t* arena, size_t block_size );
+
+/**
+ * Release all allocations of the arena at once. The blocks are kept and
+ * reused by subsequent allocations.
+ *
+ * @param arena
+ *  A pointer to the arena.
+ */
+void gar_arena_reset( gar_arena_t* arena );
+
+/**
+ * Copy a string into the arena.
+ *
+ * @param arena
+ *  A pointer to the arena.
+ * @param str
+ *  The string to copy.
+ * @return
+ *  A pointer to the copy or NULL on failure.
+ */
+char* gar_arena_strdup( gar_arena_t* arena, const char* str );
+
+#endif
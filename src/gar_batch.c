@@ -0,0 +1,1030 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include "gar_batch.h"
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * The number of samples whose screen points are projected at once. The
+ * single precision columns of one lane are kept on the stack.
+ */
+#define GAR_BATCH_LANE_SIZE 256
+
+/**
+ * Convert a column of double precision values to single precision. The main
+ * loop converts eight independent values per iteration which GCC 12 or later
+ * turns into vector instructions of the target (SSE, AVX, NEON) already at
+ * `-O2`, the default optimisation level of R packages. Older compilers only
+ * vectorise it at `-O3`.
+ *
+ * @param dst
+ *  The destination column.
+ * @param src
+ *  The source column.
+ * @param count
+ *  The number of values to convert.
+ */
+static void gar_batch_convert( float* restrict dst,
+        const double* restrict src, uint32_t count );
+
+/**
+ * Finalise the AOI analysis of the ongoing trial of one AOI set and append
+ * the result to the event list.
+ *
+ * @param aoic
+ *  A pointer to the AOI collection of the set.
+ * @param events
+ *  A pointer to the event list to append the analysis entries to.
+ * @return
+ *  True on success, false on failure.
+ */
+static bool gar_batch_finalise_set( gac_aoi_collection_t* aoic,
+        gar_events_t* events );
+
+/**
+ * Make sure that an item list is able to hold one more item. The list size
+ * is doubled if the list is full.
+ *
+ * @param items
+ *  A pointer to the item list pointer.
+ * @param count
+ *  The number of items in the list.
+ * @param size
+ *  A pointer to the number of allocated items. This is updated from within
+ *  the function.
+ * @param item_size
+ *  The size of one item in bytes.
+ * @return
+ *  True on success, false on failure.
+ */
+static bool gar_events_reserve( void** items, uint32_t count, uint32_t* size,
+        size_t item_size );
+
+/**
+ * Append the AOI analysis result to the event list. One entry is added per
+ * AOI.
+ *
+ * @param events
+ *  A pointer to the event list.
+ * @param analysis
+ *  A pointer to the AOI analysis result to add.
+ * @return
+ *  True on success, false on failure.
+ */
+static bool gar_events_add_analysis( gar_events_t* events,
+        gac_aoi_collection_analysis_result_t* analysis );
+
+/**
+ * Append a fixation to the event list.
+ *
+ * @param events
+ *  A pointer to the event list.
+ * @param fixation
+ *  A pointer to the fixation to add.
+ * @return
+ *  True on success, false on failure.
+ */
+static bool gar_events_add_fixation( gar_events_t* events,
+        gac_fixation_t* fixation );
+
+/**
+ * Append a saccade to the event list.
+ *
+ * @param events
+ *  A pointer to the event list.
+ * @param saccade
+ *  A pointer to the saccade to add.
+ * @return
+ *  True on success, false on failure.
+ */
+static bool gar_events_add_saccade( gar_events_t* events,
+        gac_saccade_t* saccade );
+
+/**
+ * Run the saccade filter, the fixation filter, and the AOI analysis on all
+ * samples which were added to the sample window by the last update.
+ *
+ * @param h
+ *  A pointer to the gaze analysis handler.
+ * @param stimuli
+ *  A pointer to the AOI sets of the gaze analysis handler or NULL.
+ * @param new_sample_count
+ *  The number of new samples in the sample window.
+ * @param has_aoi
+ *  True if the AOI analysis is enabled, false otherwise.
+ * @param events
+ *  A pointer to the event list to append the detected events to.
+ * @param defer
+ *  An optional function the detected events are handed over to instead of
+ *  running the AOI analysis (may be NULL).
+ * @param data
+ *  The data pointer passed to `defer`.
+ * @return
+ *  True on success, false on failure.
+ */
+static bool gar_batch_filter( gac_t* h, gar_stimuli_t* stimuli,
+        uint32_t new_sample_count, bool has_aoi, gar_events_t* events,
+        gar_batch_defer_t defer, void* data );
+
+/**
+ * Compute the screen points of a lane of samples with the screen of the lane.
+ *
+ * @param lane
+ *  A pointer to the lane to project. It must not hold more than
+ *  GAR_BATCH_LANE_SIZE samples and its screen must not be NULL.
+ * @param sx
+ *  The destination of the normalised x coordinates.
+ * @param sy
+ *  The destination of the normalised y coordinates.
+ */
+static void gar_batch_project_lane( gar_batch_t* lane, float* sx, float* sy );
+
+/**
+ * Fill a sample record with one sample of a lane.
+ *
+ * @param sample
+ *  A pointer to the sample record to fill.
+ * @param lane
+ *  A pointer to the lane holding the sample.
+ * @param idx
+ *  The index of the sample in the lane.
+ * @param sx
+ *  The x coordinates computed by gar_batch_screen_points() for the lane.
+ * @param sy
+ *  The y coordinates computed by gar_batch_screen_points() for the lane.
+ */
+static void gar_batch_sample( gar_sample_t* sample, gar_batch_t* lane,
+        uint32_t idx, const float* sx, const float* sy );
+
+/**
+ * Compute the screen points of a lane of samples which has no screen point
+ * columns. If the lane has a screen, the screen points are projected with
+ * it, otherwise they are set to NaN. If the lane has screen point columns,
+ * nothing is done.
+ *
+ * @param lane
+ *  A pointer to the lane. It must not hold more than GAR_BATCH_LANE_SIZE
+ *  samples.
+ * @param sx
+ *  The destination of the normalised x coordinates.
+ * @param sy
+ *  The destination of the normalised y coordinates.
+ */
+static void gar_batch_screen_points( gar_batch_t* lane, float* sx, float* sy );
+
+/**
+ * Feed one sample to the sample window and run the saccade filter and the
+ * fixation filter on each new sample (see gar_batch_parse_deferred()).
+ *
+ * @param h
+ *  A pointer to the gaze analysis handler.
+ * @param stimuli
+ *  A pointer to the AOI sets of the gaze analysis handler or NULL.
+ * @param sample
+ *  A pointer to the sample to feed.
+ * @param has_screen
+ *  True if the screen point of the sample is to be used, false otherwise.
+ * @param has_aoi
+ *  True if the AOI analysis is enabled, false otherwise.
+ * @param labels
+ *  The dictionary resolving the label ID of the sample.
+ * @param events
+ *  A pointer to the event list to append the detected events to.
+ * @param defer
+ *  The optional receiver of the detected events (may be NULL).
+ * @param data
+ *  The data pointer passed to `defer`.
+ * @return
+ *  True on success, false on failure.
+ */
+static bool gar_batch_update( gac_t* h, gar_stimuli_t* stimuli,
+        const gar_sample_t* sample, bool has_screen, bool has_aoi,
+        gar_labels_t* labels, gar_events_t* events, gar_batch_defer_t defer,
+        void* data );
+
+/**
+ * Translate the IDs of a label dictionary to the IDs of another label
+ * dictionary.
+ *
+ * @param dst
+ *  A pointer to the destination label dictionary.
+ * @param src
+ *  A pointer to the source label dictionary.
+ * @return
+ *  An allocated list where the index is the source ID and the value is the
+ *  destination ID or NULL on failure.
+ */
+static uint32_t* gar_labels_translate( gar_labels_t* dst, gar_labels_t* src );
+
+/******************************************************************************/
+bool gar_batch_analyse_fixation( gac_t* h, gar_stimuli_t* stimuli,
+        gac_fixation_t* fixation, gar_events_t* events )
+{
+    bool found;
+    uint32_t id;
+    gac_aoi_collection_analysis_result_t analysis;
+    GAR_STATS_DECLARE( t );
+
+    if( gar_stimuli_has_sets( stimuli ) )
+    {
+        // close the trial in all sets at once such that the results are in
+        // the same order as the ones of a parse of consecutive trials
+        if( stimuli->has_trial
+                && fixation->first_sample.trial_id != stimuli->trial_id
+                && !gar_batch_finalise( h, stimuli, events ) )
+        {
+            return false;
+        }
+        stimuli->has_trial = true;
+        stimuli->trial_id = fixation->first_sample.trial_id;
+
+        id = gar_stimuli_find( stimuli, fixation->first_sample.label );
+        if( id == GAR_LABEL_INVALID )
+        {
+            return true;
+        }
+        gar_stimuli_select( stimuli, h, id );
+    }
+
+    if( h->aoic.aois.count == 0 )
+    {
+        return true;
+    }
+
+    GAR_STATS_START( t );
+    found = gac_aoi_collection_analyse_fixation( &h->aoic, fixation,
+            &analysis );
+    GAR_STATS_STOP( &events->stats, time_aoi, t );
+    GAR_STATS_COUNT( &events->stats, aoi_tests, h->aoic.aois.count );
+    if( found )
+    {
+        return gar_events_add_analysis( events, &analysis );
+    }
+
+    return true;
+}
+
+/******************************************************************************/
+void gar_batch_analyse_saccade( gac_t* h, gar_stimuli_t* stimuli,
+        gac_saccade_t* saccade, gar_events_t* events )
+{
+    uint32_t id;
+    GAR_STATS_DECLARE( t );
+
+    if( gar_stimuli_has_sets( stimuli ) )
+    {
+        id = gar_stimuli_find( stimuli, saccade->first_sample.label );
+        if( id == GAR_LABEL_INVALID )
+        {
+            return;
+        }
+        gar_stimuli_select( stimuli, h, id );
+    }
+
+    if( h->aoic.aois.count == 0 )
+    {
+        return;
+    }
+
+    GAR_STATS_START( t );
+    gac_aoi_collection_analyse_saccade( &h->aoic, saccade );
+    GAR_STATS_STOP( &events->stats, time_aoi, t );
+}
+
+/******************************************************************************/
+void gar_batch_buffer_attach( gar_batch_t* batch, gar_batch_buffer_t* buffer,
+        bool has_screen, gar_labels_t* labels )
+{
+    batch->px = buffer->px;
+    batch->py = buffer->py;
+    batch->pz = buffer->pz;
+    batch->ox = buffer->ox;
+    batch->oy = buffer->oy;
+    batch->oz = buffer->oz;
+    batch->sx = has_screen ? buffer->sx : NULL;
+    batch->sy = has_screen ? buffer->sy : NULL;
+    batch->timestamp = buffer->timestamp;
+    batch->trial_id = buffer->trial_id;
+    batch->label = buffer->label;
+    batch->labels = labels;
+    batch->screen = NULL;
+    batch->count = 0;
+}
+
+/******************************************************************************/
+void gar_batch_buffer_gather( gar_batch_buffer_t* buffer, gar_batch_t* src,
+        const uint32_t* idxs, uint32_t count )
+{
+    uint32_t i, idx;
+
+    for( i = 0; i < count; i++ )
+    {
+        idx = idxs[i];
+        buffer->px[i] = src->px[idx];
+        buffer->py[i] = src->py[idx];
+        buffer->pz[i] = src->pz[idx];
+        buffer->ox[i] = src->ox[idx];
+        buffer->oy[i] = src->oy[idx];
+        buffer->oz[i] = src->oz[idx];
+        buffer->timestamp[i] = src->timestamp[idx];
+        buffer->trial_id[i] = src->trial_id[idx];
+        buffer->label[i] = src->label[idx];
+    }
+
+    if( src->sx != NULL && src->sy != NULL )
+    {
+        for( i = 0; i < count; i++ )
+        {
+            buffer->sx[i] = src->sx[idxs[i]];
+            buffer->sy[i] = src->sy[idxs[i]];
+        }
+    }
+}
+
+/******************************************************************************/
+bool gar_batch_finalise( gac_t* h, gar_stimuli_t* stimuli,
+        gar_events_t* events )
+{
+    uint32_t i;
+
+    if( !gar_stimuli_has_sets( stimuli ) )
+    {
+        return gar_batch_finalise_set( &h->aoic, events );
+    }
+
+    for( i = 0; i < stimuli->count; i++ )
+    {
+        if( !gar_batch_finalise_set( ( i == stimuli->active ) ? &h->aoic
+                    : &stimuli->sets[i], events ) )
+        {
+            return false;
+        }
+    }
+    stimuli->has_trial = false;
+
+    return true;
+}
+
+/******************************************************************************/
+static bool gar_batch_finalise_set( gac_aoi_collection_t* aoic,
+        gar_events_t* events )
+{
+    gac_aoi_collection_analysis_result_t analysis;
+
+    if( aoic->aois.count == 0 )
+    {
+        return true;
+    }
+
+    if( gac_aoi_collection_analyse_finalise( aoic, &analysis ) )
+    {
+        return gar_events_add_analysis( events, &analysis );
+    }
+
+    return true;
+}
+
+/******************************************************************************/
+static bool gar_batch_filter( gac_t* h, gar_stimuli_t* stimuli,
+        uint32_t new_sample_count, bool has_aoi, gar_events_t* events,
+        gar_batch_defer_t defer, void* data )
+{
+    uint32_t i;
+    bool res, found;
+    gac_fixation_t fixation;
+    gac_saccade_t saccade;
+    GAR_STATS_DECLARE( t );
+
+    for( i = 0; i < new_sample_count; i++ )
+    {
+        GAR_STATS_START( t );
+        found = gac_sample_window_saccade_filter( h, &saccade );
+        GAR_STATS_STOP( &events->stats, time_saccade, t );
+        if( found )
+        {
+            res = gar_events_add_saccade( events, &saccade );
+            if( defer != NULL )
+            {
+                // the saccade is destroyed by the receiver
+                res = defer( data, &saccade, NULL ) && res;
+            }
+            else
+            {
+                if( has_aoi )
+                {
+                    gar_batch_analyse_saccade( h, stimuli, &saccade, events );
+                }
+                gac_saccade_destroy( &saccade );
+            }
+            if( !res )
+            {
+                return false;
+            }
+        }
+
+        GAR_STATS_START( t );
+        found = gac_sample_window_fixation_filter( h, &fixation );
+        GAR_STATS_STOP( &events->stats, time_fixation, t );
+        if( found )
+        {
+            res = gar_events_add_fixation( events, &fixation );
+            if( defer != NULL )
+            {
+                // the fixation is destroyed by the receiver
+                res = defer( data, NULL, &fixation ) && res;
+            }
+            else
+            {
+                if( res && has_aoi )
+                {
+                    res = gar_batch_analyse_fixation( h, stimuli, &fixation,
+                            events );
+                }
+                gac_fixation_destroy( &fixation );
+            }
+            if( !res )
+            {
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+/******************************************************************************/
+static void gar_batch_convert( float* restrict dst,
+        const double* restrict src, uint32_t count )
+{
+    uint32_t i = 0;
+
+    for( ; i + 8 <= count; i += 8 )
+    {
+        dst[i] = ( float )src[i];
+        dst[i + 1] = ( float )src[i + 1];
+        dst[i + 2] = ( float )src[i + 2];
+        dst[i + 3] = ( float )src[i + 3];
+        dst[i + 4] = ( float )src[i + 4];
+        dst[i + 5] = ( float )src[i + 5];
+        dst[i + 6] = ( float )src[i + 6];
+        dst[i + 7] = ( float )src[i + 7];
+    }
+    for( ; i < count; i++ )
+    {
+        dst[i] = ( float )src[i];
+    }
+}
+
+/******************************************************************************/
+void gar_batch_pack( gar_batch_t* batch, gar_sample_t* samples )
+{
+    float sx[GAR_BATCH_LANE_SIZE];
+    float sy[GAR_BATCH_LANE_SIZE];
+    uint32_t i, j;
+    gar_batch_t lane;
+
+    for( i = 0; i < batch->count; i += lane.count )
+    {
+        gar_batch_slice( &lane, batch, i, GAR_BATCH_LANE_SIZE );
+        gar_batch_screen_points( &lane, sx, sy );
+        for( j = 0; j < lane.count; j++ )
+        {
+            gar_batch_sample( &samples[i + j], &lane, j, sx, sy );
+        }
+    }
+}
+
+/******************************************************************************/
+bool gar_batch_parse( gac_t* h, gar_stimuli_t* stimuli, gar_batch_t* batch,
+        gar_events_t* events )
+{
+    return gar_batch_parse_columns( h, stimuli, batch,
+            gar_stimuli_has_aoi( stimuli, h ), events, NULL, NULL );
+}
+
+/******************************************************************************/
+bool gar_batch_parse_columns( gac_t* h, gar_stimuli_t* stimuli,
+        gar_batch_t* batch, bool has_aoi, gar_events_t* events,
+        gar_batch_defer_t defer, void* data )
+{
+    float sx[GAR_BATCH_LANE_SIZE];
+    float sy[GAR_BATCH_LANE_SIZE];
+    uint32_t i, j;
+    gar_batch_t lane;
+    gar_sample_t sample;
+    bool has_screen = ( batch->sx != NULL && batch->sy != NULL )
+        || batch->screen != NULL;
+    GAR_STATS_DECLARE_ALLOCS( allocs );
+
+    GAR_STATS_COUNT( &events->stats, samples_in, batch->count );
+    GAR_STATS_ALLOCS_START( allocs );
+    for( i = 0; i < batch->count; i += lane.count )
+    {
+        gar_batch_slice( &lane, batch, i, GAR_BATCH_LANE_SIZE );
+        gar_batch_screen_points( &lane, sx, sy );
+        for( j = 0; j < lane.count; j++ )
+        {
+            gar_batch_sample( &sample, &lane, j, sx, sy );
+            if( !gar_batch_update( h, stimuli, &sample, has_screen, has_aoi,
+                        batch->labels, events, defer, data ) )
+            {
+                return false;
+            }
+        }
+    }
+    GAR_STATS_ALLOCS_STOP( &events->stats, allocs );
+
+    return true;
+}
+
+/******************************************************************************/
+bool gar_batch_parse_deferred( gac_t* h, gar_stimuli_t* stimuli,
+        const gar_sample_t* samples, uint32_t count, bool has_screen,
+        bool has_aoi, gar_labels_t* labels, gar_events_t* events,
+        gar_batch_defer_t defer, void* data )
+{
+    uint32_t i;
+    GAR_STATS_DECLARE_ALLOCS( allocs );
+
+    GAR_STATS_COUNT( &events->stats, samples_in, count );
+    GAR_STATS_ALLOCS_START( allocs );
+    for( i = 0; i < count; i++ )
+    {
+        if( !gar_batch_update( h, stimuli, &samples[i], has_screen, has_aoi,
+                    labels, events, defer, data ) )
+        {
+            return false;
+        }
+    }
+    GAR_STATS_ALLOCS_STOP( &events->stats, allocs );
+
+    return true;
+}
+
+/******************************************************************************/
+bool gar_batch_parse_samples( gac_t* h, gar_stimuli_t* stimuli,
+        const gar_sample_t* samples, uint32_t count, bool has_screen,
+        gar_labels_t* labels, gar_events_t* events )
+{
+    return gar_batch_parse_deferred( h, stimuli, samples, count, has_screen,
+            gar_stimuli_has_aoi( stimuli, h ), labels, events, NULL, NULL );
+}
+
+/******************************************************************************/
+void gar_batch_project( gar_batch_t* batch, double* sx, double* sy )
+{
+    float lane_sx[GAR_BATCH_LANE_SIZE];
+    float lane_sy[GAR_BATCH_LANE_SIZE];
+    uint32_t i, j;
+    gar_batch_t lane;
+
+    for( i = 0; i < batch->count; i += lane.count )
+    {
+        gar_batch_slice( &lane, batch, i, GAR_BATCH_LANE_SIZE );
+        gar_batch_project_lane( &lane, lane_sx, lane_sy );
+        for( j = 0; j < lane.count; j++ )
+        {
+            sx[i + j] = lane_sx[j];
+            sy[i + j] = lane_sy[j];
+        }
+    }
+}
+
+/******************************************************************************/
+static void gar_batch_project_lane( gar_batch_t* lane, float* sx, float* sy )
+{
+    float px[GAR_BATCH_LANE_SIZE];
+    float py[GAR_BATCH_LANE_SIZE];
+    float pz[GAR_BATCH_LANE_SIZE];
+    float ox[GAR_BATCH_LANE_SIZE];
+    float oy[GAR_BATCH_LANE_SIZE];
+    float oz[GAR_BATCH_LANE_SIZE];
+
+    gar_batch_convert( px, lane->px, lane->count );
+    gar_batch_convert( py, lane->py, lane->count );
+    gar_batch_convert( pz, lane->pz, lane->count );
+    gar_batch_convert( ox, lane->ox, lane->count );
+    gar_batch_convert( oy, lane->oy, lane->count );
+    gar_batch_convert( oz, lane->oz, lane->count );
+    gar_screen_project( lane->screen, px, py, pz, ox, oy, oz, sx, sy,
+            lane->count );
+}
+
+/******************************************************************************/
+static void gar_batch_sample( gar_sample_t* sample, gar_batch_t* lane,
+        uint32_t idx, const float* sx, const float* sy )
+{
+    sample->point[0] = ( float )lane->px[idx];
+    sample->point[1] = ( float )lane->py[idx];
+    sample->point[2] = ( float )lane->pz[idx];
+    sample->origin[0] = ( float )lane->ox[idx];
+    sample->origin[1] = ( float )lane->oy[idx];
+    sample->origin[2] = ( float )lane->oz[idx];
+    if( lane->sx != NULL && lane->sy != NULL )
+    {
+        sample->screen_point[0] = ( float )lane->sx[idx];
+        sample->screen_point[1] = ( float )lane->sy[idx];
+    }
+    else
+    {
+        sample->screen_point[0] = sx[idx];
+        sample->screen_point[1] = sy[idx];
+    }
+    sample->timestamp = lane->timestamp[idx];
+    sample->trial_id = lane->trial_id[idx];
+    sample->label = ( lane->label != NULL ) ? lane->label[idx]
+        : GAR_LABEL_BLANK;
+}
+
+/******************************************************************************/
+static void gar_batch_screen_points( gar_batch_t* lane, float* sx, float* sy )
+{
+    uint32_t i;
+
+    if( lane->sx != NULL && lane->sy != NULL )
+    {
+        return;
+    }
+
+    if( lane->screen != NULL )
+    {
+        gar_batch_project_lane( lane, sx, sy );
+        return;
+    }
+
+    for( i = 0; i < lane->count; i++ )
+    {
+        sx[i] = NAN;
+        sy[i] = NAN;
+    }
+}
+
+/******************************************************************************/
+void gar_batch_slice( gar_batch_t* batch, gar_batch_t* src, uint32_t offset,
+        uint32_t count )
+{
+    batch->px = src->px + offset;
+    batch->py = src->py + offset;
+    batch->pz = src->pz + offset;
+    batch->ox = src->ox + offset;
+    batch->oy = src->oy + offset;
+    batch->oz = src->oz + offset;
+    batch->sx = ( src->sx != NULL ) ? src->sx + offset : NULL;
+    batch->sy = ( src->sy != NULL ) ? src->sy + offset : NULL;
+    batch->timestamp = src->timestamp + offset;
+    batch->trial_id = src->trial_id + offset;
+    batch->label = ( src->label != NULL ) ? src->label + offset : NULL;
+    batch->labels = src->labels;
+    batch->screen = src->screen;
+    batch->count = ( src->count - offset < count ) ? src->count - offset
+        : count;
+}
+
+/******************************************************************************/
+static bool gar_events_add_analysis( gar_events_t* events,
+        gac_aoi_collection_analysis_result_t* analysis )
+{
+    uint32_t i;
+    gac_aoi_analysis_t* aoi;
+    gar_analysis_item_t* item;
+    double label_timestamp;
+
+    for( i = 0; i < analysis->aois.count; i++ )
+    {
+        if( !gar_events_reserve( ( void** )&events->analyses,
+                    events->analysis_count, &events->analysis_size,
+                    sizeof( gar_analysis_item_t ) ) )
+        {
+            return false;
+        }
+        aoi = &analysis->aois.items[i].analysis;
+        item = &events->analyses[events->analysis_count];
+        item->trial_id = analysis->trial_id;
+        item->trial_timestamp = gac_sample_get_trial_timestamp(
+                &aoi->first_fixation.first_sample );
+        label_timestamp = gac_sample_get_label_timestamp(
+                &aoi->first_fixation.first_sample );
+        item->first_saccade_start_onset = gac_sample_get_onset(
+                &aoi->first_saccade.first_sample, item->trial_timestamp );
+        item->first_saccade_end_onset = gac_sample_get_onset(
+                &aoi->first_saccade.last_sample, item->trial_timestamp );
+        item->first_fixation_onset = gac_sample_get_onset(
+                &aoi->first_fixation.first_sample, item->trial_timestamp );
+        item->label_onset = label_timestamp - item->trial_timestamp;
+        if( item->label_onset < 0 )
+        {
+            item->label_onset = 0;
+        }
+        item->first_saccade_latency = item->first_saccade_start_onset
+            - item->label_onset;
+        item->dwell_time = aoi->dwell_time;
+        item->dwell_time_rel = aoi->dwell_time_relative;
+        item->first_fixation_duration = aoi->first_fixation.duration;
+        item->prior_aoi_visited_count = aoi->aoi_visited_before_count;
+        item->saccade_enter_count = aoi->enter_saccade_count;
+        item->fixation_count_rel = aoi->fixation_count_relative;
+        item->fixation_count = aoi->fixation_count;
+        item->aoi_name = gar_labels_intern( &events->aoi_names,
+                analysis->aois.items[i].label );
+        if( item->aoi_name == GAR_LABEL_INVALID )
+        {
+            return false;
+        }
+        events->analysis_count++;
+        GAR_STATS_COUNT( &events->stats, analyses, 1 );
+    }
+
+    return true;
+}
+
+/******************************************************************************/
+static bool gar_events_add_fixation( gar_events_t* events,
+        gac_fixation_t* fixation )
+{
+    gar_fixation_item_t* item;
+
+    if( !gar_events_reserve( ( void** )&events->fixations,
+                events->fixation_count, &events->fixation_size,
+                sizeof( gar_fixation_item_t ) ) )
+    {
+        return false;
+    }
+
+    item = &events->fixations[events->fixation_count];
+    item->screen_point[0] = fixation->screen_point[0];
+    item->screen_point[1] = fixation->screen_point[1];
+    item->point[0] = fixation->point[0];
+    item->point[1] = fixation->point[1];
+    item->point[2] = fixation->point[2];
+    item->duration = fixation->duration;
+    item->timestamp = fixation->first_sample.timestamp;
+    item->trial_id = fixation->first_sample.trial_id;
+    item->trial_onset = fixation->first_sample.trial_onset;
+    item->label = gar_labels_intern( &events->labels,
+            fixation->first_sample.label );
+    item->label_onset = fixation->first_sample.label_onset;
+    if( item->label == GAR_LABEL_INVALID )
+    {
+        return false;
+    }
+    events->fixation_count++;
+    GAR_STATS_COUNT( &events->stats, fixations, 1 );
+
+    return true;
+}
+
+/******************************************************************************/
+static bool gar_events_add_saccade( gar_events_t* events,
+        gac_saccade_t* saccade )
+{
+    gar_saccade_item_t* item;
+
+    if( !gar_events_reserve( ( void** )&events->saccades,
+                events->saccade_count, &events->saccade_size,
+                sizeof( gar_saccade_item_t ) ) )
+    {
+        return false;
+    }
+
+    item = &events->saccades[events->saccade_count];
+    item->start_screen_point[0] = saccade->first_sample.screen_point[0];
+    item->start_screen_point[1] = saccade->first_sample.screen_point[1];
+    item->start_point[0] = saccade->first_sample.point[0];
+    item->start_point[1] = saccade->first_sample.point[1];
+    item->start_point[2] = saccade->first_sample.point[2];
+    item->dest_screen_point[0] = saccade->last_sample.screen_point[0];
+    item->dest_screen_point[1] = saccade->last_sample.screen_point[1];
+    item->dest_point[0] = saccade->last_sample.point[0];
+    item->dest_point[1] = saccade->last_sample.point[1];
+    item->dest_point[2] = saccade->last_sample.point[2];
+    item->duration = saccade->last_sample.timestamp
+        - saccade->first_sample.timestamp;
+    item->timestamp = saccade->first_sample.timestamp;
+    item->trial_id = saccade->first_sample.trial_id;
+    item->trial_onset = saccade->first_sample.trial_onset;
+    item->label = gar_labels_intern( &events->labels,
+            saccade->first_sample.label );
+    item->label_onset = saccade->first_sample.label_onset;
+    if( item->label == GAR_LABEL_INVALID )
+    {
+        return false;
+    }
+    events->saccade_count++;
+    GAR_STATS_COUNT( &events->stats, saccades, 1 );
+
+    return true;
+}
+
+/******************************************************************************/
+bool gar_events_append( gar_events_t* dst, gar_events_t* src )
+{
+    uint32_t i;
+    uint32_t* labels;
+    uint32_t* aoi_names;
+    bool res = true;
+
+    labels = gar_labels_translate( &dst->labels, &src->labels );
+    aoi_names = gar_labels_translate( &dst->aoi_names, &src->aoi_names );
+    if( labels == NULL || aoi_names == NULL )
+    {
+        free( labels );
+        free( aoi_names );
+        return false;
+    }
+
+    for( i = 0; res && i < src->fixation_count; i++ )
+    {
+        res = gar_events_reserve( ( void** )&dst->fixations,
+                dst->fixation_count, &dst->fixation_size,
+                sizeof( gar_fixation_item_t ) );
+        if( res )
+        {
+            dst->fixations[dst->fixation_count] = src->fixations[i];
+            dst->fixations[dst->fixation_count].label =
+                labels[src->fixations[i].label];
+            dst->fixation_count++;
+        }
+    }
+    for( i = 0; res && i < src->saccade_count; i++ )
+    {
+        res = gar_events_reserve( ( void** )&dst->saccades,
+                dst->saccade_count, &dst->saccade_size,
+                sizeof( gar_saccade_item_t ) );
+        if( res )
+        {
+            dst->saccades[dst->saccade_count] = src->saccades[i];
+            dst->saccades[dst->saccade_count].label =
+                labels[src->saccades[i].label];
+            dst->saccade_count++;
+        }
+    }
+    for( i = 0; res && i < src->analysis_count; i++ )
+    {
+        res = gar_events_reserve( ( void** )&dst->analyses,
+                dst->analysis_count, &dst->analysis_size,
+                sizeof( gar_analysis_item_t ) );
+        if( res )
+        {
+            dst->analyses[dst->analysis_count] = src->analyses[i];
+            dst->analyses[dst->analysis_count].aoi_name =
+                aoi_names[src->analyses[i].aoi_name];
+            dst->analysis_count++;
+        }
+    }
+
+    free( labels );
+    free( aoi_names );
+
+    if( res )
+    {
+        gar_stats_add( &dst->stats, &src->stats );
+    }
+
+    return res;
+}
+
+/******************************************************************************/
+void gar_events_clear( gar_events_t* events )
+{
+    events->fixation_count = 0;
+    events->saccade_count = 0;
+    events->analysis_count = 0;
+    memset( &events->stats, 0, sizeof( gar_stats_t ) );
+}
+
+/******************************************************************************/
+void gar_events_destroy( gar_events_t* events )
+{
+    free( events->fixations );
+    free( events->saccades );
+    free( events->analyses );
+    gar_labels_destroy( &events->labels );
+    gar_labels_destroy( &events->aoi_names );
+    memset( events, 0, sizeof( gar_events_t ) );
+}
+
+/******************************************************************************/
+bool gar_events_init( gar_events_t* events, gar_arena_t* arena )
+{
+    memset( events, 0, sizeof( gar_events_t ) );
+
+    if( !gar_labels_init( &events->labels, arena ) )
+    {
+        return false;
+    }
+    if( !gar_labels_init( &events->aoi_names, arena ) )
+    {
+        gar_labels_destroy( &events->labels );
+        return false;
+    }
+
+    return true;
+}
+
+/******************************************************************************/
+void gar_events_reset( gar_events_t* events )
+{
+    gar_events_clear( events );
+    gar_labels_clear( &events->labels );
+    gar_labels_clear( &events->aoi_names );
+    if( events->labels.arena != NULL )
+    {
+        gar_arena_reset( events->labels.arena );
+    }
+}
+
+/******************************************************************************/
+static bool gar_events_reserve( void** items, uint32_t count, uint32_t* size,
+        size_t item_size )
+{
+    void* new_items;
+    uint32_t new_size;
+
+    if( count < *size )
+    {
+        return true;
+    }
+
+    new_size = ( *size == 0 ) ? 64 : *size * 2;
+    new_items = realloc( *items, new_size * item_size );
+    if( new_items == NULL )
+    {
+        return false;
+    }
+
+    *items = new_items;
+    *size = new_size;
+
+    return true;
+}
+
+/******************************************************************************/
+static uint32_t* gar_labels_translate( gar_labels_t* dst, gar_labels_t* src )
+{
+    uint32_t i;
+    uint32_t* ids;
+
+    ids = malloc( src->count * sizeof( uint32_t ) );
+    if( ids == NULL )
+    {
+        return NULL;
+    }
+
+    for( i = 0; i < src->count; i++ )
+    {
+        ids[i] = gar_labels_intern( dst, src->items[i] );
+        if( ids[i] == GAR_LABEL_INVALID )
+        {
+            free( ids );
+            return NULL;
+        }
+    }
+
+    return ids;
+}
+
+/******************************************************************************/
+static bool gar_batch_update( gac_t* h, gar_stimuli_t* stimuli,
+        const gar_sample_t* sample, bool has_screen, bool has_aoi,
+        gar_labels_t* labels, gar_events_t* events, gar_batch_defer_t defer,
+        void* data )
+{
+    uint32_t new_sample_count;
+    GAR_STATS_DECLARE( t );
+
+    GAR_STATS_START( t );
+    if( has_screen )
+    {
+        new_sample_count = gac_sample_window_update_screen( h,
+                sample->origin[0], sample->origin[1], sample->origin[2],
+                sample->point[0], sample->point[1], sample->point[2],
+                sample->screen_point[0], sample->screen_point[1],
+                sample->timestamp, sample->trial_id,
+                gar_labels_get( labels, sample->label ) );
+    }
+    else
+    {
+        new_sample_count = gac_sample_window_update( h,
+                sample->origin[0], sample->origin[1], sample->origin[2],
+                sample->point[0], sample->point[1], sample->point[2],
+                sample->timestamp, sample->trial_id,
+                gar_labels_get( labels, sample->label ) );
+    }
+    GAR_STATS_STOP( &events->stats, time_update, t );
+    GAR_STATS_COUNT( &events->stats, samples_added, new_sample_count );
+    if( !gar_batch_filter( h, stimuli, new_sample_count, has_aoi, events,
+                defer, data ) )
+    {
+        return false;
+    }
+    GAR_STATS_START( t );
+    gac_sample_window_cleanup( h );
+    GAR_STATS_STOP( &events->stats, time_cleanup, t );
+
+    return true;
+}
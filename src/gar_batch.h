@@ -0,0 +1,585 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef GAR_BATCH_H
+#define GAR_BATCH_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "gac.h"
+#include "gac_aoi_collection.h"
+#include "gar_labels.h"
+#include "gar_screen.h"
+#include "gar_stats.h"
+#include "gar_stimuli.h"
+
+/** The maximal number of samples passed to the parser in one batch block. */
+#define GAR_BATCH_SIZE 4096
+
+/** The size of a cache line in bytes a packed sample record must fit in. */
+#define GAR_SAMPLE_CACHE_LINE 64
+
+/** A block of input samples in structure-of-arrays layout. */
+typedef struct gar_batch_s gar_batch_t;
+/** Storage for one block of input samples. */
+typedef struct gar_batch_buffer_s gar_batch_buffer_t;
+/** A packed sample record as it is stored between parser stages. */
+typedef struct gar_sample_s gar_sample_t;
+/** The list of events detected while parsing batch blocks. */
+typedef struct gar_events_s gar_events_t;
+/** A fixation as it is reported to R. */
+typedef struct gar_fixation_item_s gar_fixation_item_t;
+/** A saccade as it is reported to R. */
+typedef struct gar_saccade_item_s gar_saccade_item_t;
+/** A single AOI row of an AOI analysis result as it is reported to R. */
+typedef struct gar_analysis_item_s gar_analysis_item_t;
+
+/**
+ * Receive a saccade or a fixation detected by gar_batch_parse_deferred() for
+ * a deferred AOI analysis. Exactly one of the two pointers is not NULL. The
+ * receiver takes over the event and must destroy it with
+ * gac_saccade_destroy() or gac_fixation_destroy() respectively, also on
+ * failure.
+ *
+ * @param data
+ *  The data pointer passed to gar_batch_parse_deferred().
+ * @param saccade
+ *  A pointer to the detected saccade or NULL.
+ * @param fixation
+ *  A pointer to the detected fixation or NULL.
+ * @return
+ *  True on success, false on failure.
+ */
+typedef bool ( *gar_batch_defer_t )( void* data, gac_saccade_t* saccade,
+        gac_fixation_t* fixation );
+
+/**
+ * A block of input samples. Each pointer points to the first sample of the
+ * block and each array must hold at least `count` elements.
+ */
+struct gar_batch_s
+{
+    /** The x coordinates of the gaze points. */
+    const double* px;
+    /** The y coordinates of the gaze points. */
+    const double* py;
+    /** The z coordinates of the gaze points. */
+    const double* pz;
+    /** The x coordinates of the gaze origins. */
+    const double* ox;
+    /** The y coordinates of the gaze origins. */
+    const double* oy;
+    /** The z coordinates of the gaze origins. */
+    const double* oz;
+    /** The optional x coordinates of the screen points (may be NULL). */
+    const double* sx;
+    /** The optional y coordinates of the screen points (may be NULL). */
+    const double* sy;
+    /** The timestamps of the samples in milliseconds. */
+    const double* timestamp;
+    /** The trial IDs of the samples. */
+    const int* trial_id;
+    /** The label IDs of the samples. */
+    const uint32_t* label;
+    /** The dictionary resolving the label IDs of the samples. */
+    gar_labels_t* labels;
+    /** The optional screen the screen points are computed with if `sx` and
+     * `sy` are NULL (may be NULL). */
+    const gar_screen_t* screen;
+    /** The number of samples in the block. */
+    uint32_t count;
+};
+
+/**
+ * Storage for one block of samples. This is used if the samples are not
+ * available as contiguous columns and need to be gathered first.
+ */
+struct gar_batch_buffer_s
+{
+    /** The x coordinates of the gaze points. */
+    double px[GAR_BATCH_SIZE];
+    /** The y coordinates of the gaze points. */
+    double py[GAR_BATCH_SIZE];
+    /** The z coordinates of the gaze points. */
+    double pz[GAR_BATCH_SIZE];
+    /** The x coordinates of the gaze origins. */
+    double ox[GAR_BATCH_SIZE];
+    /** The y coordinates of the gaze origins. */
+    double oy[GAR_BATCH_SIZE];
+    /** The z coordinates of the gaze origins. */
+    double oz[GAR_BATCH_SIZE];
+    /** The x coordinates of the screen points. */
+    double sx[GAR_BATCH_SIZE];
+    /** The y coordinates of the screen points. */
+    double sy[GAR_BATCH_SIZE];
+    /** The timestamps of the samples in milliseconds. */
+    double timestamp[GAR_BATCH_SIZE];
+    /** The trial IDs of the samples. */
+    int trial_id[GAR_BATCH_SIZE];
+    /** The label IDs of the samples. */
+    uint32_t label[GAR_BATCH_SIZE];
+};
+
+/**
+ * A packed sample record holding all values which are fed to the sample
+ * window per sample. This is the format samples are stored in if they are
+ * kept beyond the call which received them: between the stages of the
+ * parser pipeline, for all configurations of a sweep, and in the queue of an
+ * online handler. Samples which are parsed directly from their columns are
+ * not packed (see gar_batch_parse_columns()). The coordinates are stored in
+ * single precision, the precision of the gac filters, and the label is
+ * stored as ID of a label dictionary. The timestamp is kept in double
+ * precision as an int64 offset would not make the record any smaller.
+ */
+struct gar_sample_s
+{
+    /** The gaze point. */
+    float point[3];
+    /** The gaze origin. */
+    float origin[3];
+    /** The normalised screen point. */
+    float screen_point[2];
+    /** The timestamp of the sample in milliseconds. */
+    double timestamp;
+    /** The trial ID of the sample. */
+    int32_t trial_id;
+    /** The label ID of the sample. */
+    uint32_t label;
+};
+
+_Static_assert( sizeof( gar_sample_t ) <= GAR_SAMPLE_CACHE_LINE,
+        "a packed sample must fit in a cache line" );
+_Static_assert( sizeof( gar_sample_t ) == 48,
+        "a packed sample must not have any padding" );
+_Static_assert( offsetof( gar_sample_t, timestamp ) % sizeof( double ) == 0,
+        "the timestamp of a packed sample must be aligned" );
+
+/**
+ * A fixation entry.
+ */
+struct gar_fixation_item_s
+{
+    /** The average screen point of the fixation. */
+    double screen_point[2];
+    /** The average gaze point of the fixation. */
+    double point[3];
+    /** The duration of the fixation in milliseconds. */
+    double duration;
+    /** The timestamp of the first sample of the fixation. */
+    double timestamp;
+    /** The trial ID of the first sample of the fixation. */
+    int32_t trial_id;
+    /** The trial onset of the first sample of the fixation. */
+    double trial_onset;
+    /** The label ID of the first sample of the fixation. */
+    uint32_t label;
+    /** The label onset of the first sample of the fixation. */
+    double label_onset;
+};
+
+/**
+ * A saccade entry.
+ */
+struct gar_saccade_item_s
+{
+    /** The screen point of the first sample of the saccade. */
+    double start_screen_point[2];
+    /** The gaze point of the first sample of the saccade. */
+    double start_point[3];
+    /** The screen point of the last sample of the saccade. */
+    double dest_screen_point[2];
+    /** The gaze point of the last sample of the saccade. */
+    double dest_point[3];
+    /** The duration of the saccade in milliseconds. */
+    double duration;
+    /** The timestamp of the first sample of the saccade. */
+    double timestamp;
+    /** The trial ID of the first sample of the saccade. */
+    int32_t trial_id;
+    /** The trial onset of the first sample of the saccade. */
+    double trial_onset;
+    /** The label ID of the first sample of the saccade. */
+    uint32_t label;
+    /** The label onset of the first sample of the saccade. */
+    double label_onset;
+};
+
+/**
+ * An AOI analysis entry of a single AOI.
+ */
+struct gar_analysis_item_s
+{
+    /** The trial ID of the analysed trial. */
+    int32_t trial_id;
+    /** The timestamp of the trial start. */
+    double trial_timestamp;
+    /** The sum of all fixation durations on the AOI. */
+    double dwell_time;
+    /** The relative dwell time within the trial. */
+    double dwell_time_rel;
+    /** The duration of the first fixation on the AOI. */
+    double first_fixation_duration;
+    /** The onset of the first fixation on the AOI. */
+    double first_fixation_onset;
+    /** The number of AOIs visited before the AOI. */
+    int32_t prior_aoi_visited_count;
+    /** The onset of the start of the first saccade entering the AOI. */
+    double first_saccade_start_onset;
+    /** The onset of the end of the first saccade entering the AOI. */
+    double first_saccade_end_onset;
+    /** The first saccade start with respect to the label change. */
+    double first_saccade_latency;
+    /** The number of saccades entering the AOI. */
+    int32_t saccade_enter_count;
+    /** The relative fixation count within the trial. */
+    double fixation_count_rel;
+    /** The number of fixations on the AOI. */
+    int32_t fixation_count;
+    /** The ID of the AOI name. */
+    uint32_t aoi_name;
+    /** The time from the trial start to the last label change. */
+    double label_onset;
+};
+
+/**
+ * The events detected while parsing. The item lists grow on demand and keep
+ * their capacity when the list is cleared. Labels and AOI names of the
+ * events are interned into dictionaries which are shared by all events of
+ * the list and which optionally draw their strings from an arena.
+ */
+struct gar_events_s
+{
+    /** The dictionary of sample labels. */
+    gar_labels_t labels;
+    /** The dictionary of AOI names. */
+    gar_labels_t aoi_names;
+    /** The list of detected fixations. */
+    gar_fixation_item_t* fixations;
+    /** The number of detected fixations. */
+    uint32_t fixation_count;
+    /** The number of allocated fixation items. */
+    uint32_t fixation_size;
+    /** The list of detected saccades. */
+    gar_saccade_item_t* saccades;
+    /** The number of detected saccades. */
+    uint32_t saccade_count;
+    /** The number of allocated saccade items. */
+    uint32_t saccade_size;
+    /** The list of AOI analysis entries. */
+    gar_analysis_item_t* analyses;
+    /** The number of AOI analysis entries. */
+    uint32_t analysis_count;
+    /** The number of allocated AOI analysis items. */
+    uint32_t analysis_size;
+    /** The parser statistics collected while filling the list. These are
+     * only updated if the package is built with GAR_STATS. */
+    gar_stats_t stats;
+};
+
+/**
+ * Run the AOI analysis on a fixation and append the analysis result of a
+ * completed trial to the event list. If the label of the fixation selects
+ * another AOI set than the active one, the AOI set of the label is activated
+ * first. The analysis state of the previously active set is kept until its
+ * trial is completed. If the fixation belongs to another trial than the
+ * previously analysed fixation, the analysis of all sets is finalised. The
+ * first fixation after the sets were finalised opens a trial without
+ * finalising them again. A fixation whose label selects no AOI set is not
+ * analysed.
+ *
+ * @param h
+ *  A pointer to the gaze analysis handler holding the AOIs.
+ * @param stimuli
+ *  A pointer to the AOI sets of the gaze analysis handler or NULL.
+ * @param fixation
+ *  A pointer to the fixation to analyse.
+ * @param events
+ *  A pointer to the event list to append the analysis entries to.
+ * @return
+ *  True on success, false on failure.
+ */
+bool gar_batch_analyse_fixation( gac_t* h, gar_stimuli_t* stimuli,
+        gac_fixation_t* fixation, gar_events_t* events );
+
+/**
+ * Run the AOI analysis on a saccade. The AOI set is selected by the label of
+ * the saccade like for fixations (see gar_batch_analyse_fixation()).
+ *
+ * @param h
+ *  A pointer to the gaze analysis handler holding the AOIs.
+ * @param stimuli
+ *  A pointer to the AOI sets of the gaze analysis handler or NULL.
+ * @param saccade
+ *  A pointer to the saccade to analyse.
+ * @param events
+ *  A pointer to the event list the analysis time is accounted to.
+ */
+void gar_batch_analyse_saccade( gac_t* h, gar_stimuli_t* stimuli,
+        gac_saccade_t* saccade, gar_events_t* events );
+
+/**
+ * Let a batch point to the columns of a batch buffer.
+ *
+ * @param batch
+ *  A pointer to the batch to update.
+ * @param buffer
+ *  A pointer to the batch buffer.
+ * @param has_screen
+ *  True if the screen point columns are to be used, false otherwise.
+ * @param labels
+ *  The dictionary resolving the label IDs of the buffer.
+ */
+void gar_batch_buffer_attach( gar_batch_t* batch, gar_batch_buffer_t* buffer,
+        bool has_screen, gar_labels_t* labels );
+
+/**
+ * Copy a set of samples from a batch of columns into a batch buffer.
+ *
+ * @param buffer
+ *  A pointer to the batch buffer to fill.
+ * @param src
+ *  A pointer to the batch holding the complete source columns.
+ * @param idxs
+ *  The indices of the samples in the source columns to copy.
+ * @param count
+ *  The number of samples to copy. This must not exceed GAR_BATCH_SIZE.
+ */
+void gar_batch_buffer_gather( gar_batch_buffer_t* buffer, gar_batch_t* src,
+        const uint32_t* idxs, uint32_t count );
+
+/**
+ * Finalise the AOI analysis of the ongoing trial and append the result to
+ * the event list. With AOI sets, the analysis of each set is finalised in
+ * the order of the set indices.
+ *
+ * @param h
+ *  A pointer to the gaze analysis handler.
+ * @param stimuli
+ *  A pointer to the AOI sets of the gaze analysis handler or NULL.
+ * @param events
+ *  A pointer to the event list to append the analysis entries to.
+ * @return
+ *  True on success, false on failure.
+ */
+bool gar_batch_finalise( gac_t* h, gar_stimuli_t* stimuli,
+        gar_events_t* events );
+
+/**
+ * Convert a block of samples to packed sample records. If the block has no
+ * screen points but a screen, the screen points are computed with the
+ * screen. If the block has neither, the screen points are set to NaN.
+ *
+ * @param batch
+ *  A pointer to the block of samples to convert.
+ * @param samples
+ *  The destination list holding at least `batch->count` records.
+ */
+void gar_batch_pack( gar_batch_t* batch, gar_sample_t* samples );
+
+/**
+ * Feed a block of samples to the sample window and run the saccade filter,
+ * the fixation filter, and the AOI analysis on each new sample. All detected
+ * events are appended to the event list. If the block has no screen points
+ * but a screen, the screen points are computed block-wise before the
+ * samples are passed to the sample window. This is equal to
+ * gar_batch_parse_columns() without a receiver.
+ *
+ * @param h
+ *  A pointer to the gaze analysis handler.
+ * @param stimuli
+ *  A pointer to the AOI sets of the gaze analysis handler or NULL.
+ * @param batch
+ *  A pointer to the block of samples to parse.
+ * @param events
+ *  A pointer to the event list to append the detected events to.
+ * @return
+ *  True on success, false on failure.
+ */
+bool gar_batch_parse( gac_t* h, gar_stimuli_t* stimuli, gar_batch_t* batch,
+        gar_events_t* events );
+
+/**
+ * Feed a block of samples to the sample window directly from its columns
+ * and run the saccade filter and the fixation filter on each new sample. All
+ * detected events are appended to the event list. If a receiver is given,
+ * each detected saccade and fixation is handed over to it instead of running
+ * the AOI analysis (see gar_batch_parse_deferred()).
+ *
+ * @param h
+ *  A pointer to the gaze analysis handler.
+ * @param stimuli
+ *  A pointer to the AOI sets of the gaze analysis handler or NULL.
+ * @param batch
+ *  A pointer to the block of samples to parse.
+ * @param has_aoi
+ *  True if the AOI analysis is enabled, false otherwise (see
+ *  gar_batch_parse_deferred()).
+ * @param events
+ *  A pointer to the event list to append the detected events to.
+ * @param defer
+ *  The optional receiver of the detected events (may be NULL).
+ * @param data
+ *  The data pointer passed to the receiver.
+ * @return
+ *  True on success, false on failure.
+ */
+bool gar_batch_parse_columns( gac_t* h, gar_stimuli_t* stimuli,
+        gar_batch_t* batch, bool has_aoi, gar_events_t* events,
+        gar_batch_defer_t defer, void* data );
+
+/**
+ * Feed a list of packed sample records to the sample window and run the
+ * saccade filter and the fixation filter on each new sample. All detected
+ * events are appended to the event list. If a receiver is given, each
+ * detected saccade and fixation is handed over to it instead of running the
+ * AOI analysis such that the analysis can run on another thread. Otherwise
+ * this is equal to gar_batch_parse_samples().
+ *
+ * @param h
+ *  A pointer to the gaze analysis handler.
+ * @param stimuli
+ *  A pointer to the AOI sets of the gaze analysis handler or NULL.
+ * @param samples
+ *  The packed sample records to parse.
+ * @param count
+ *  The number of sample records.
+ * @param has_screen
+ *  True if the screen points of the records are to be used, false
+ *  otherwise.
+ * @param has_aoi
+ *  True if the AOI analysis is enabled, false otherwise. It is passed in
+ *  such that the AOI collection is not accessed if the AOI analysis runs on
+ *  another thread (see gar_stimuli_has_aoi()).
+ * @param labels
+ *  The dictionary resolving the label IDs of the records.
+ * @param events
+ *  A pointer to the event list to append the detected events to.
+ * @param defer
+ *  The optional receiver of the detected events (may be NULL).
+ * @param data
+ *  The data pointer passed to the receiver.
+ * @return
+ *  True on success, false on failure.
+ */
+bool gar_batch_parse_deferred( gac_t* h, gar_stimuli_t* stimuli,
+        const gar_sample_t* samples, uint32_t count, bool has_screen,
+        bool has_aoi, gar_labels_t* labels, gar_events_t* events,
+        gar_batch_defer_t defer, void* data );
+
+/**
+ * Feed a list of packed sample records to the sample window and run the
+ * saccade filter, the fixation filter, and the AOI analysis on each new
+ * sample (see gar_batch_parse()).
+ *
+ * @param h
+ *  A pointer to the gaze analysis handler.
+ * @param stimuli
+ *  A pointer to the AOI sets of the gaze analysis handler or NULL.
+ * @param samples
+ *  The packed sample records to parse.
+ * @param count
+ *  The number of sample records.
+ * @param has_screen
+ *  True if the screen points of the records are to be used, false
+ *  otherwise.
+ * @param labels
+ *  The dictionary resolving the label IDs of the records.
+ * @param events
+ *  A pointer to the event list to append the detected events to.
+ * @return
+ *  True on success, false on failure.
+ */
+bool gar_batch_parse_samples( gac_t* h, gar_stimuli_t* stimuli,
+        const gar_sample_t* samples, uint32_t count, bool has_screen,
+        gar_labels_t* labels, gar_events_t* events );
+
+/**
+ * Compute the screen points of a block of samples with the screen of the
+ * block (see gar_screen_project()).
+ *
+ * @param batch
+ *  A pointer to the block of samples to project. The screen of the block
+ *  must not be NULL.
+ * @param sx
+ *  The destination of the normalised x coordinates.
+ * @param sy
+ *  The destination of the normalised y coordinates.
+ */
+void gar_batch_project( gar_batch_t* batch, double* sx, double* sy );
+
+/**
+ * Append all events of an event list to another event list. Label IDs are
+ * translated to the label dictionaries of the destination list and the
+ * statistics are added to the statistics of the destination list.
+ *
+ * @param dst
+ *  A pointer to the event list to append the events to.
+ * @param src
+ *  A pointer to the event list holding the events to append.
+ * @return
+ *  True on success, false on failure.
+ */
+bool gar_events_append( gar_events_t* dst, gar_events_t* src );
+
+/**
+ * Let a batch point to a range of samples of another batch.
+ *
+ * @param batch
+ *  A pointer to the batch to update.
+ * @param src
+ *  A pointer to the batch holding the source columns.
+ * @param offset
+ *  The index of the first sample of the range in the source batch.
+ * @param count
+ *  The maximal number of samples of the range. The range is truncated at
+ *  the end of the source batch.
+ */
+void gar_batch_slice( gar_batch_t* batch, gar_batch_t* src, uint32_t offset,
+        uint32_t count );
+
+/**
+ * Remove all events from the event list and reset its statistics. The
+ * allocated memory and the label dictionaries are kept for later use.
+ *
+ * @param events
+ *  A pointer to the event list to clear.
+ */
+void gar_events_clear( gar_events_t* events );
+
+/**
+ * Release all memory held by the event list.
+ *
+ * @param events
+ *  A pointer to the event list to destroy.
+ */
+void gar_events_destroy( gar_events_t* events );
+
+/**
+ * Initialise an empty event list.
+ *
+ * @param events
+ *  A pointer to the event list to initialise.
+ * @param arena
+ *  An optional arena to draw the label strings from (see
+ *  gar_events_reset()). If NULL, each label string is allocated
+ *  individually.
+ * @return
+ *  True on success, false on failure.
+ */
+bool gar_events_init( gar_events_t* events, gar_arena_t* arena );
+
+/**
+ * Remove all events and labels from the event list and reset its statistics.
+ * The allocated memory is kept for later use and the arena of the label
+ * dictionaries is reset at once.
+ *
+ * @param events
+ *  A pointer to the event list to reset.
+ */
+void gar_events_reset( gar_events_t* events );
+
+#endif
@@ -0,0 +1,608 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include "gar_csv.h"
+#include <fcntl.h>
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/** The column names as they appear in the header line. */
+static const char* gar_csv_column_names[GAR_CSV_COLUMN_COUNT] = {
+    "", "sx", "sy", "px", "py", "pz", "ox", "oy", "oz", "timestamp",
+    "trial_id", "label", "svalid", "pvalid", "ovalid"
+};
+
+/** Powers of ten which are exactly representable as double. */
+static const double gar_csv_pow10[] = {
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11, 1e12,
+    1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+/**
+ * Find the end of a field and strip enclosing double quotes. Quoted fields
+ * must not span multiple lines.
+ *
+ * @param p
+ *  A pointer to the start of the field.
+ * @param end
+ *  A pointer to the end of the line.
+ * @param field
+ *  A pointer to a variable where the start of the field content is stored.
+ * @param field_end
+ *  A pointer to a variable where the end of the field content is stored.
+ * @return
+ *  A pointer to the comma terminating the field or the end of the line.
+ */
+static const char* gar_csv_field( const char* p, const char* end,
+        const char** field, const char** field_end );
+
+/**
+ * Map a header field to a column type.
+ *
+ * @param field
+ *  The start of the field content.
+ * @param field_end
+ *  The end of the field content.
+ * @return
+ *  The column type or GAR_CSV_COLUMN_NONE if the column is unknown.
+ */
+static gar_csv_column_t gar_csv_column( const char* field,
+        const char* field_end );
+
+/**
+ * Intern the label of a field. Escaped double quotes are unescaped.
+ *
+ * @param csv
+ *  A pointer to the CSV reader.
+ * @param labels
+ *  The dictionary to intern the label into.
+ * @param field
+ *  The start of the field content.
+ * @param field_end
+ *  The end of the field content.
+ * @return
+ *  The label ID or GAR_LABEL_INVALID on failure.
+ */
+static uint32_t gar_csv_label( gar_csv_t* csv, gar_labels_t* labels,
+        const char* field, const char* field_end );
+
+/**
+ * Parse a logical value. Only "True", "TRUE", "true", "T", and "1" are true.
+ *
+ * @param field
+ *  The start of the field content.
+ * @param field_end
+ *  The end of the field content.
+ * @return
+ *  The parsed value.
+ */
+static bool gar_csv_parse_bool( const char* field, const char* field_end );
+
+/**
+ * Parse a floating point number. The parser ignores the locale and is
+ * correctly rounded for up to 15 significant digits and decimal exponents
+ * within +/-22 which covers all values written by eye tracker software.
+ * Empty fields, "NA", "NaN", and malformed numbers are parsed as NaN.
+ *
+ * @param field
+ *  The start of the field content.
+ * @param field_end
+ *  The end of the field content.
+ * @return
+ *  The parsed value.
+ */
+static double gar_csv_parse_double( const char* field, const char* field_end );
+
+/**
+ * Parse an integer. Empty fields, "NA", and malformed numbers are parsed as
+ * INT32_MIN which corresponds to `NA_integer_` in R.
+ *
+ * @param field
+ *  The start of the field content.
+ * @param field_end
+ *  The end of the field content.
+ * @return
+ *  The parsed value.
+ */
+static int32_t gar_csv_parse_int( const char* field, const char* field_end );
+
+/**
+ * Get the next line of the file. Carriage returns at the end of the line
+ * are stripped.
+ *
+ * @param csv
+ *  A pointer to the CSV reader.
+ * @param line_end
+ *  A pointer to a variable where the end of the line is stored.
+ * @return
+ *  The start of the line or NULL at the end of the file.
+ */
+static const char* gar_csv_line( gar_csv_t* csv, const char** line_end );
+
+/******************************************************************************/
+void gar_csv_close( gar_csv_t* csv )
+{
+    if( csv->data != NULL )
+    {
+        munmap( ( void* )csv->data, csv->size );
+    }
+    if( csv->fd >= 0 )
+    {
+        close( csv->fd );
+    }
+    free( csv->label );
+    csv->data = NULL;
+    csv->fd = -1;
+    csv->label = NULL;
+    csv->label_size = 0;
+}
+
+/******************************************************************************/
+static gar_csv_column_t gar_csv_column( const char* field,
+        const char* field_end )
+{
+    gar_csv_column_t i;
+    size_t len = field_end - field;
+
+    for( i = GAR_CSV_COLUMN_NONE + 1; i < GAR_CSV_COLUMN_COUNT; i++ )
+    {
+        if( strlen( gar_csv_column_names[i] ) == len
+                && memcmp( gar_csv_column_names[i], field, len ) == 0 )
+        {
+            return i;
+        }
+    }
+
+    return GAR_CSV_COLUMN_NONE;
+}
+
+/******************************************************************************/
+static const char* gar_csv_field( const char* p, const char* end,
+        const char** field, const char** field_end )
+{
+    if( p < end && *p == '"' )
+    {
+        p++;
+        *field = p;
+        while( p < end && !( *p == '"' && ( p + 1 == end || p[1] != '"' ) ) )
+        {
+            p += ( *p == '"' ) ? 2 : 1;
+        }
+        *field_end = p;
+        while( p < end && *p != ',' )
+        {
+            p++;
+        }
+        return p;
+    }
+
+    *field = p;
+    while( p < end && *p != ',' )
+    {
+        p++;
+    }
+    *field_end = p;
+
+    return p;
+}
+
+/******************************************************************************/
+static uint32_t gar_csv_label( gar_csv_t* csv, gar_labels_t* labels,
+        const char* field, const char* field_end )
+{
+    char* label;
+    size_t len = field_end - field;
+    size_t i = 0;
+
+    if( len == 0 )
+    {
+        return GAR_LABEL_BLANK;
+    }
+
+    if( len + 1 > csv->label_size )
+    {
+        label = realloc( csv->label, len + 1 );
+        if( label == NULL )
+        {
+            return GAR_LABEL_INVALID;
+        }
+        csv->label = label;
+        csv->label_size = len + 1;
+    }
+
+    while( field < field_end )
+    {
+        csv->label[i++] = *field;
+        field += ( *field == '"' ) ? 2 : 1;
+    }
+    csv->label[i] = '\0';
+
+    return gar_labels_intern( labels, csv->label );
+}
+
+/******************************************************************************/
+static const char* gar_csv_line( gar_csv_t* csv, const char** line_end )
+{
+    const char* line;
+    const char* end = csv->data + csv->size;
+
+    if( csv->pos >= csv->size )
+    {
+        return NULL;
+    }
+
+    line = csv->data + csv->pos;
+    *line_end = memchr( line, '\n', end - line );
+    if( *line_end == NULL )
+    {
+        *line_end = end;
+    }
+    csv->pos = *line_end - csv->data + 1;
+    csv->line++;
+
+    if( *line_end > line && ( *line_end )[-1] == '\r' )
+    {
+        ( *line_end )--;
+    }
+
+    return line;
+}
+
+/******************************************************************************/
+bool gar_csv_open( gar_csv_t* csv, const char* path, bool has_screen )
+{
+    struct stat st;
+    const char* line;
+    const char* line_end;
+    const char* field;
+    const char* field_end;
+    gar_csv_column_t column;
+    gar_csv_column_t i;
+
+    memset( csv, 0, sizeof( gar_csv_t ) );
+    csv->fd = open( path, O_RDONLY );
+    if( csv->fd < 0 )
+    {
+        csv->error = "failed to open the file";
+        return false;
+    }
+
+    if( fstat( csv->fd, &st ) != 0 || st.st_size == 0 )
+    {
+        csv->error = "the file is empty";
+        return false;
+    }
+
+    csv->size = st.st_size;
+    csv->data = mmap( NULL, csv->size, PROT_READ, MAP_PRIVATE, csv->fd, 0 );
+    if( csv->data == MAP_FAILED )
+    {
+        csv->data = NULL;
+        csv->error = "failed to map the file into memory";
+        return false;
+    }
+#ifdef MADV_SEQUENTIAL
+    madvise( ( void* )csv->data, csv->size, MADV_SEQUENTIAL );
+#endif
+
+    if( csv->size >= 3 && memcmp( csv->data, "\xEF\xBB\xBF", 3 ) == 0 )
+    {
+        csv->pos = 3;
+    }
+
+    line = gar_csv_line( csv, &line_end );
+    if( line == NULL )
+    {
+        csv->error = "the file is empty";
+        return false;
+    }
+
+    while( line <= line_end )
+    {
+        if( csv->column_count == GAR_CSV_MAX_COLUMNS )
+        {
+            csv->error = "the header line holds too many columns";
+            return false;
+        }
+        line = gar_csv_field( line, line_end, &field, &field_end );
+        column = gar_csv_column( field, field_end );
+        csv->columns[csv->column_count++] = column;
+        csv->has_column[column] = true;
+        line++;
+    }
+
+    for( i = GAR_CSV_COLUMN_SX; i <= GAR_CSV_COLUMN_TIMESTAMP; i++ )
+    {
+        if( !csv->has_column[i] && ( has_screen
+                    || ( i != GAR_CSV_COLUMN_SX && i != GAR_CSV_COLUMN_SY ) ) )
+        {
+            csv->error = "the header line misses a required column";
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/******************************************************************************/
+static bool gar_csv_parse_bool( const char* field, const char* field_end )
+{
+    size_t len = field_end - field;
+
+    switch( len )
+    {
+        case 1:
+            return *field == 'T' || *field == '1';
+        case 4:
+            return memcmp( field, "True", 4 ) == 0
+                || memcmp( field, "TRUE", 4 ) == 0
+                || memcmp( field, "true", 4 ) == 0;
+        default:
+            return false;
+    }
+}
+
+/******************************************************************************/
+static double gar_csv_parse_double( const char* field, const char* field_end )
+{
+    const char* p = field;
+    uint64_t mantissa = 0;
+    int32_t exponent = 0;
+    int32_t exp_value = 0;
+    uint32_t digits = 0;
+    bool negative = false;
+    bool exp_negative = false;
+    bool has_digits = false;
+    double value;
+
+    if( p < field_end && ( *p == '-' || *p == '+' ) )
+    {
+        negative = ( *p == '-' );
+        p++;
+    }
+
+    if( p < field_end && ( *p == 'I' || *p == 'i' ) )
+    {
+        return negative ? -INFINITY : INFINITY;
+    }
+
+    while( p < field_end && *p >= '0' && *p <= '9' )
+    {
+        if( digits < 19 )
+        {
+            mantissa = mantissa * 10 + ( *p - '0' );
+            digits += ( mantissa > 0 );
+        }
+        else
+        {
+            exponent++;
+        }
+        has_digits = true;
+        p++;
+    }
+
+    if( p < field_end && *p == '.' )
+    {
+        p++;
+        while( p < field_end && *p >= '0' && *p <= '9' )
+        {
+            if( digits < 19 )
+            {
+                mantissa = mantissa * 10 + ( *p - '0' );
+                digits += ( mantissa > 0 );
+                exponent--;
+            }
+            has_digits = true;
+            p++;
+        }
+    }
+
+    if( !has_digits )
+    {
+        return NAN;
+    }
+
+    if( p < field_end && ( *p == 'e' || *p == 'E' ) )
+    {
+        p++;
+        if( p < field_end && ( *p == '-' || *p == '+' ) )
+        {
+            exp_negative = ( *p == '-' );
+            p++;
+        }
+        while( p < field_end && *p >= '0' && *p <= '9' )
+        {
+            if( exp_value < 10000 )
+            {
+                exp_value = exp_value * 10 + ( *p - '0' );
+            }
+            p++;
+        }
+        exponent += exp_negative ? -exp_value : exp_value;
+    }
+
+    if( p != field_end )
+    {
+        return NAN;
+    }
+
+    value = ( double )mantissa;
+    while( exponent < -22 )
+    {
+        value /= 1e22;
+        exponent += 22;
+    }
+    while( exponent > 22 )
+    {
+        value *= 1e22;
+        exponent -= 22;
+    }
+    if( exponent < 0 )
+    {
+        value /= gar_csv_pow10[-exponent];
+    }
+    else
+    {
+        value *= gar_csv_pow10[exponent];
+    }
+
+    return negative ? -value : value;
+}
+
+/******************************************************************************/
+static int32_t gar_csv_parse_int( const char* field, const char* field_end )
+{
+    const char* p = field;
+    int64_t value = 0;
+    bool negative = false;
+
+    if( p < field_end && ( *p == '-' || *p == '+' ) )
+    {
+        negative = ( *p == '-' );
+        p++;
+    }
+
+    if( p == field_end )
+    {
+        return INT32_MIN;
+    }
+
+    while( p < field_end && *p >= '0' && *p <= '9' )
+    {
+        value = value * 10 + ( *p - '0' );
+        if( value > INT32_MAX )
+        {
+            return INT32_MIN;
+        }
+        p++;
+    }
+
+    if( p != field_end )
+    {
+        return INT32_MIN;
+    }
+
+    return ( int32_t )( negative ? -value : value );
+}
+
+/******************************************************************************/
+bool gar_csv_read( gar_csv_t* csv, gar_batch_buffer_t* buffer,
+        gar_labels_t* labels, uint32_t* count )
+{
+    const char* line;
+    const char* line_end;
+    const char* field;
+    const char* field_end;
+    const char* label;
+    const char* label_end;
+    uint32_t i, j;
+    bool valid;
+
+    i = 0;
+    while( i < GAR_BATCH_SIZE
+            && ( line = gar_csv_line( csv, &line_end ) ) != NULL )
+    {
+        if( line == line_end )
+        {
+            continue;
+        }
+
+        buffer->sx[i] = NAN;
+        buffer->sy[i] = NAN;
+        buffer->trial_id[i] = 0;
+        buffer->label[i] = GAR_LABEL_BLANK;
+        label = NULL;
+        label_end = NULL;
+        valid = true;
+
+        for( j = 0; line <= line_end; j++ )
+        {
+            if( j == csv->column_count )
+            {
+                csv->error = "a line holds more fields than the header line";
+                return false;
+            }
+            line = gar_csv_field( line, line_end, &field, &field_end );
+            line++;
+            switch( csv->columns[j] )
+            {
+                case GAR_CSV_COLUMN_SX:
+                    buffer->sx[i] = gar_csv_parse_double( field, field_end );
+                    break;
+                case GAR_CSV_COLUMN_SY:
+                    buffer->sy[i] = gar_csv_parse_double( field, field_end );
+                    break;
+                case GAR_CSV_COLUMN_PX:
+                    buffer->px[i] = gar_csv_parse_double( field, field_end );
+                    break;
+                case GAR_CSV_COLUMN_PY:
+                    buffer->py[i] = gar_csv_parse_double( field, field_end );
+                    break;
+                case GAR_CSV_COLUMN_PZ:
+                    buffer->pz[i] = gar_csv_parse_double( field, field_end );
+                    break;
+                case GAR_CSV_COLUMN_OX:
+                    buffer->ox[i] = gar_csv_parse_double( field, field_end );
+                    break;
+                case GAR_CSV_COLUMN_OY:
+                    buffer->oy[i] = gar_csv_parse_double( field, field_end );
+                    break;
+                case GAR_CSV_COLUMN_OZ:
+                    buffer->oz[i] = gar_csv_parse_double( field, field_end );
+                    break;
+                case GAR_CSV_COLUMN_TIMESTAMP:
+                    buffer->timestamp[i] = gar_csv_parse_double( field,
+                            field_end );
+                    break;
+                case GAR_CSV_COLUMN_TRIAL_ID:
+                    buffer->trial_id[i] = gar_csv_parse_int( field,
+                            field_end );
+                    break;
+                case GAR_CSV_COLUMN_LABEL:
+                    label = field;
+                    label_end = field_end;
+                    break;
+                case GAR_CSV_COLUMN_SVALID:
+                case GAR_CSV_COLUMN_PVALID:
+                case GAR_CSV_COLUMN_OVALID:
+                    valid = valid && gar_csv_parse_bool( field, field_end );
+                    break;
+                default:
+                    break;
+            }
+        }
+
+        if( j != csv->column_count )
+        {
+            csv->error = "a line holds less fields than the header line";
+            return false;
+        }
+
+        if( !valid )
+        {
+            continue;
+        }
+
+        if( label != label_end )
+        {
+            buffer->label[i] = gar_csv_label( csv, labels, label, label_end );
+            if( buffer->label[i] == GAR_LABEL_INVALID )
+            {
+                csv->error = "failed to allocate memory for a label";
+                return false;
+            }
+        }
+        i++;
+    }
+
+    *count = i;
+
+    return true;
+}
@@ -0,0 +1,125 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef GAR_CSV_H
+#define GAR_CSV_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "gar_batch.h"
+#include "gar_labels.h"
+
+/** The maximal number of columns of a CSV file. */
+#define GAR_CSV_MAX_COLUMNS 64
+
+/** A memory-mapped CSV file holding gaze samples. */
+typedef struct gar_csv_s gar_csv_t;
+/** The known columns of a gaze sample CSV file. */
+typedef enum gar_csv_column_e gar_csv_column_t;
+
+/**
+ * The known columns of a gaze sample CSV file. The columns are identified by
+ * the name in the header line (see `example/gaze.csv`).
+ */
+enum gar_csv_column_e
+{
+    GAR_CSV_COLUMN_NONE,
+    GAR_CSV_COLUMN_SX,
+    GAR_CSV_COLUMN_SY,
+    GAR_CSV_COLUMN_PX,
+    GAR_CSV_COLUMN_PY,
+    GAR_CSV_COLUMN_PZ,
+    GAR_CSV_COLUMN_OX,
+    GAR_CSV_COLUMN_OY,
+    GAR_CSV_COLUMN_OZ,
+    GAR_CSV_COLUMN_TIMESTAMP,
+    GAR_CSV_COLUMN_TRIAL_ID,
+    GAR_CSV_COLUMN_LABEL,
+    GAR_CSV_COLUMN_SVALID,
+    GAR_CSV_COLUMN_PVALID,
+    GAR_CSV_COLUMN_OVALID,
+    GAR_CSV_COLUMN_COUNT
+};
+
+/**
+ * A memory-mapped CSV file. The file is read sequentially, one block of
+ * samples at a time.
+ */
+struct gar_csv_s
+{
+    /** The file descriptor of the file. */
+    int fd;
+    /** The start of the mapped file. */
+    const char* data;
+    /** The size of the mapped file in bytes. */
+    size_t size;
+    /** The offset of the next line to read. */
+    size_t pos;
+    /** The number of the next line to read. */
+    uint32_t line;
+    /** The column type of each field of a line. */
+    gar_csv_column_t columns[GAR_CSV_MAX_COLUMNS];
+    /** The number of fields of a line. */
+    uint32_t column_count;
+    /** True if a column of each type is present, false otherwise. */
+    bool has_column[GAR_CSV_COLUMN_COUNT];
+    /** Scratch buffer holding the unquoted label of a line. */
+    char* label;
+    /** The size of the label scratch buffer. */
+    size_t label_size;
+    /** A description of the last error. */
+    const char* error;
+};
+
+/**
+ * Unmap the file and release all memory held by the CSV reader.
+ *
+ * @param csv
+ *  A pointer to the CSV reader.
+ */
+void gar_csv_close( gar_csv_t* csv );
+
+/**
+ * Map a CSV file into memory and read its header line.
+ *
+ * @param csv
+ *  A pointer to the CSV reader to initialise.
+ * @param path
+ *  The path to the CSV file.
+ * @param has_screen
+ *  True if the screen point columns are required, false otherwise.
+ * @return
+ *  True on success, false on failure. On failure, `csv->error` describes the
+ *  problem and the reader must still be closed.
+ */
+bool gar_csv_open( gar_csv_t* csv, const char* path, bool has_screen );
+
+/**
+ * Read the next block of samples into a batch buffer. Samples where one of
+ * the validity flags svalid, pvalid, or ovalid is not true are skipped.
+ * Missing numeric values are read as NaN, a missing trial ID is read as the
+ * smallest integer (`NA_integer_` in R), and labels of valid samples are
+ * interned into the label dictionary. If the file has no trial ID or label
+ * column, the trial ID 0 and the blank label are used.
+ *
+ * @param csv
+ *  A pointer to the CSV reader.
+ * @param buffer
+ *  A pointer to the batch buffer to fill.
+ * @param labels
+ *  The dictionary to intern the labels into.
+ * @param count
+ *  A pointer to a variable where the number of read samples is stored. A
+ *  count of zero indicates the end of the file.
+ * @return
+ *  True on success, false on failure. On failure, `csv->error` describes the
+ *  problem.
+ */
+bool gar_csv_read( gar_csv_t* csv, gar_batch_buffer_t* buffer,
+        gar_labels_t* labels, uint32_t* count );
+
+#endif
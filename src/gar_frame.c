@@ -0,0 +1,726 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include "gar_frame.h"
+#include <R_ext/Altrep.h>
+#include <stdlib.h>
+#include <string.h>
+
+/** The number of entries of a static column description list. */
+#define GAR_FRAME_COLUMN_COUNT( columns ) \
+    ( sizeof( columns ) / sizeof( gar_frame_column_t ) )
+
+/** The ALTREP class of integer and factor columns. */
+static R_altrep_class_t gar_frame_integer_class;
+
+/** The ALTREP class of numeric columns. */
+static R_altrep_class_t gar_frame_real_class;
+
+/** The ALTREP class of character columns. */
+static R_altrep_class_t gar_frame_string_class;
+
+/** The columns of an AOI analysis data frame. */
+static const gar_frame_column_t gar_frame_analysis_columns[] = {
+    { "trial_id", GAR_FRAME_COLUMN_INTEGER,
+        offsetof( gar_analysis_item_t, trial_id ) },
+    { "trial_timestamp", GAR_FRAME_COLUMN_REAL,
+        offsetof( gar_analysis_item_t, trial_timestamp ) },
+    { "dwell_time", GAR_FRAME_COLUMN_REAL,
+        offsetof( gar_analysis_item_t, dwell_time ) },
+    { "dwell_time_rel", GAR_FRAME_COLUMN_REAL,
+        offsetof( gar_analysis_item_t, dwell_time_rel ) },
+    { "first_fixation_duration", GAR_FRAME_COLUMN_REAL,
+        offsetof( gar_analysis_item_t, first_fixation_duration ) },
+    { "first_fixation_onset", GAR_FRAME_COLUMN_REAL,
+        offsetof( gar_analysis_item_t, first_fixation_onset ) },
+    { "prior_aoi_visited_count", GAR_FRAME_COLUMN_INTEGER,
+        offsetof( gar_analysis_item_t, prior_aoi_visited_count ) },
+    { "first_saccade_start_onset", GAR_FRAME_COLUMN_REAL,
+        offsetof( gar_analysis_item_t, first_saccade_start_onset ) },
+    { "first_saccade_end_onset", GAR_FRAME_COLUMN_REAL,
+        offsetof( gar_analysis_item_t, first_saccade_end_onset ) },
+    { "first_saccade_latency", GAR_FRAME_COLUMN_REAL,
+        offsetof( gar_analysis_item_t, first_saccade_latency ) },
+    { "saccade_enter_count", GAR_FRAME_COLUMN_INTEGER,
+        offsetof( gar_analysis_item_t, saccade_enter_count ) },
+    { "fixation_count_rel", GAR_FRAME_COLUMN_REAL,
+        offsetof( gar_analysis_item_t, fixation_count_rel ) },
+    { "fixation_count", GAR_FRAME_COLUMN_INTEGER,
+        offsetof( gar_analysis_item_t, fixation_count ) },
+    { "aoi_name", GAR_FRAME_COLUMN_LABEL,
+        offsetof( gar_analysis_item_t, aoi_name ) },
+    { "label_onset", GAR_FRAME_COLUMN_REAL,
+        offsetof( gar_analysis_item_t, label_onset ) }
+};
+
+/** The columns of a fixation data frame. */
+static const gar_frame_column_t gar_frame_fixation_columns[] = {
+    { "sx", GAR_FRAME_COLUMN_REAL,
+        offsetof( gar_fixation_item_t, screen_point[0] ) },
+    { "sy", GAR_FRAME_COLUMN_REAL,
+        offsetof( gar_fixation_item_t, screen_point[1] ) },
+    { "px", GAR_FRAME_COLUMN_REAL,
+        offsetof( gar_fixation_item_t, point[0] ) },
+    { "py", GAR_FRAME_COLUMN_REAL,
+        offsetof( gar_fixation_item_t, point[1] ) },
+    { "pz", GAR_FRAME_COLUMN_REAL,
+        offsetof( gar_fixation_item_t, point[2] ) },
+    { "duration", GAR_FRAME_COLUMN_REAL,
+        offsetof( gar_fixation_item_t, duration ) },
+    { "timestamp", GAR_FRAME_COLUMN_REAL,
+        offsetof( gar_fixation_item_t, timestamp ) },
+    { "trial_id", GAR_FRAME_COLUMN_INTEGER,
+        offsetof( gar_fixation_item_t, trial_id ) },
+    { "trial_onset", GAR_FRAME_COLUMN_REAL,
+        offsetof( gar_fixation_item_t, trial_onset ) },
+    { "label", GAR_FRAME_COLUMN_LABEL,
+        offsetof( gar_fixation_item_t, label ) },
+    { "label_onset", GAR_FRAME_COLUMN_REAL,
+        offsetof( gar_fixation_item_t, label_onset ) }
+};
+
+/** The columns of a saccade data frame. */
+static const gar_frame_column_t gar_frame_saccade_columns[] = {
+    { "start_screen_x", GAR_FRAME_COLUMN_REAL,
+        offsetof( gar_saccade_item_t, start_screen_point[0] ) },
+    { "start_screen_y", GAR_FRAME_COLUMN_REAL,
+        offsetof( gar_saccade_item_t, start_screen_point[1] ) },
+    { "start_x", GAR_FRAME_COLUMN_REAL,
+        offsetof( gar_saccade_item_t, start_point[0] ) },
+    { "start_y", GAR_FRAME_COLUMN_REAL,
+        offsetof( gar_saccade_item_t, start_point[1] ) },
+    { "start_z", GAR_FRAME_COLUMN_REAL,
+        offsetof( gar_saccade_item_t, start_point[2] ) },
+    { "dest_screen_x", GAR_FRAME_COLUMN_REAL,
+        offsetof( gar_saccade_item_t, dest_screen_point[0] ) },
+    { "dest_screen_y", GAR_FRAME_COLUMN_REAL,
+        offsetof( gar_saccade_item_t, dest_screen_point[1] ) },
+    { "dest_x", GAR_FRAME_COLUMN_REAL,
+        offsetof( gar_saccade_item_t, dest_point[0] ) },
+    { "dest_y", GAR_FRAME_COLUMN_REAL,
+        offsetof( gar_saccade_item_t, dest_point[1] ) },
+    { "dest_z", GAR_FRAME_COLUMN_REAL,
+        offsetof( gar_saccade_item_t, dest_point[2] ) },
+    { "duration", GAR_FRAME_COLUMN_REAL,
+        offsetof( gar_saccade_item_t, duration ) },
+    { "timestamp", GAR_FRAME_COLUMN_REAL,
+        offsetof( gar_saccade_item_t, timestamp ) },
+    { "trial_id", GAR_FRAME_COLUMN_INTEGER,
+        offsetof( gar_saccade_item_t, trial_id ) },
+    { "trial_onset", GAR_FRAME_COLUMN_REAL,
+        offsetof( gar_saccade_item_t, trial_onset ) },
+    { "label", GAR_FRAME_COLUMN_LABEL,
+        offsetof( gar_saccade_item_t, label ) },
+    { "label_onset", GAR_FRAME_COLUMN_REAL,
+        offsetof( gar_saccade_item_t, label_onset ) }
+};
+
+/**
+ * Create a lazy column of a data frame.
+ *
+ * @param data
+ *  The external pointer owning the event items of the data frame.
+ * @param column
+ *  A pointer to the static description of the column.
+ * @param factor
+ *  True if a label column is to be created as factor, false if it is to be
+ *  created as character vector.
+ * @return
+ *  The ALTREP column.
+ */
+static SEXP gar_frame_column_create( SEXP data,
+        const gar_frame_column_t* column, bool factor );
+
+/**
+ * Get the event items and the description of a lazy column.
+ *
+ * @param x
+ *  The ALTREP column.
+ * @param data
+ *  A location where the pointer to the event items is stored.
+ * @return
+ *  A pointer to the description of the column.
+ */
+static const gar_frame_column_t* gar_frame_column_get( SEXP x,
+        const gar_frame_data_t** data );
+
+/**
+ * Get the label strings of a lazy label column.
+ *
+ * @param x
+ *  The ALTREP column.
+ * @return
+ *  The label strings where the index corresponds to the label ID.
+ */
+static SEXP gar_frame_column_levels( SEXP x );
+
+/**
+ * ALTREP method: Get the data pointer of a column. The column is converted
+ * to a regular R vector on the first call.
+ *
+ * @param x
+ *  The ALTREP column.
+ * @param writeable
+ *  True if the data is going to be modified.
+ * @return
+ *  The pointer to the data of the regular R vector.
+ */
+static void* gar_frame_column_dataptr( SEXP x, Rboolean writeable );
+
+/**
+ * ALTREP method: Get the data pointer of a column if it was already
+ * converted to a regular R vector.
+ *
+ * @param x
+ *  The ALTREP column.
+ * @return
+ *  The pointer to the data or NULL if the column was not yet converted.
+ */
+static const void* gar_frame_column_dataptr_or_null( SEXP x );
+
+/**
+ * ALTREP method: Duplicate a column into a regular R vector without
+ * converting the column itself.
+ *
+ * @param x
+ *  The ALTREP column.
+ * @param deep
+ *  Ignored, the elements of the columns are atomic.
+ * @return
+ *  The regular R vector.
+ */
+static SEXP gar_frame_column_duplicate( SEXP x, Rboolean deep );
+
+/**
+ * ALTREP method: Get the number of elements of a column.
+ *
+ * @param x
+ *  The ALTREP column.
+ * @return
+ *  The number of elements.
+ */
+static R_xlen_t gar_frame_column_length( SEXP x );
+
+/**
+ * Create a regular R vector holding all elements of a column.
+ *
+ * @param x
+ *  The ALTREP column.
+ * @return
+ *  The regular R vector.
+ */
+static SEXP gar_frame_column_materialise( SEXP x );
+
+/**
+ * Limit a region of a column to the elements of the column.
+ *
+ * @param x
+ *  The ALTREP column.
+ * @param start
+ *  The index of the first element of the region.
+ * @param n
+ *  The requested number of elements.
+ * @return
+ *  The number of elements available in the region.
+ */
+static R_xlen_t gar_frame_column_region( SEXP x, R_xlen_t start,
+        R_xlen_t n );
+
+/**
+ * Create a lazy data frame from a list of event items.
+ *
+ * @param items
+ *  The event items. They are copied.
+ * @param count
+ *  The number of event items.
+ * @param size
+ *  The size of one event item in bytes.
+ * @param columns
+ *  The descriptions of the columns of the data frame.
+ * @param column_count
+ *  The number of columns.
+ * @param levels
+ *  The label strings where the index corresponds to the label ID.
+ * @param factor
+ *  True if label columns are to be created as factor, false if they are to
+ *  be created as character vector.
+ * @return
+ *  The data frame.
+ */
+static SEXP gar_frame_create( const void* items, uint32_t count, size_t size,
+        const gar_frame_column_t* columns, uint32_t column_count, SEXP levels,
+        bool factor );
+
+/**
+ * Finaliser of the external pointer owning the event items of a data frame.
+ *
+ * @param ptr
+ *  The external pointer.
+ */
+static void gar_frame_data_finalise( SEXP ptr );
+
+/**
+ * ALTREP method: Get an element of an integer or factor column.
+ *
+ * @param x
+ *  The ALTREP column.
+ * @param i
+ *  The index of the element.
+ * @return
+ *  The element.
+ */
+static int gar_frame_integer_elt( SEXP x, R_xlen_t i );
+
+/**
+ * ALTREP method: Copy a region of an integer or factor column.
+ *
+ * @param x
+ *  The ALTREP column.
+ * @param start
+ *  The index of the first element to copy.
+ * @param n
+ *  The number of elements to copy.
+ * @param buf
+ *  The destination buffer holding at least `n` elements.
+ * @return
+ *  The number of copied elements.
+ */
+static R_xlen_t gar_frame_integer_get_region( SEXP x, R_xlen_t start,
+        R_xlen_t n, int* buf );
+
+/**
+ * ALTREP method: Get an element of a numeric column.
+ *
+ * @param x
+ *  The ALTREP column.
+ * @param i
+ *  The index of the element.
+ * @return
+ *  The element.
+ */
+static double gar_frame_real_elt( SEXP x, R_xlen_t i );
+
+/**
+ * ALTREP method: Copy a region of a numeric column.
+ *
+ * @param x
+ *  The ALTREP column.
+ * @param start
+ *  The index of the first element to copy.
+ * @param n
+ *  The number of elements to copy.
+ * @param buf
+ *  The destination buffer holding at least `n` elements.
+ * @return
+ *  The number of copied elements.
+ */
+static R_xlen_t gar_frame_real_get_region( SEXP x, R_xlen_t start,
+        R_xlen_t n, double* buf );
+
+/**
+ * ALTREP method: Get an element of a character column.
+ *
+ * @param x
+ *  The ALTREP column.
+ * @param i
+ *  The index of the element.
+ * @return
+ *  The element.
+ */
+static SEXP gar_frame_string_elt( SEXP x, R_xlen_t i );
+
+/**
+ * ALTREP method: Set an element of a character column. The column is
+ * converted to a regular R vector first.
+ *
+ * @param x
+ *  The ALTREP column.
+ * @param i
+ *  The index of the element.
+ * @param v
+ *  The new element.
+ */
+static void gar_frame_string_set_elt( SEXP x, R_xlen_t i, SEXP v );
+
+/******************************************************************************/
+SEXP gar_frame_analyses_create( gar_events_t* events, SEXP levels,
+        bool factor )
+{
+    return gar_frame_create( events->analyses, events->analysis_count,
+            sizeof( gar_analysis_item_t ), gar_frame_analysis_columns,
+            GAR_FRAME_COLUMN_COUNT( gar_frame_analysis_columns ), levels,
+            factor );
+}
+
+/******************************************************************************/
+static SEXP gar_frame_column_create( SEXP data,
+        const gar_frame_column_t* column, bool factor )
+{
+    SEXP ptr, ret;
+
+    ptr = PROTECT( R_MakeExternalPtr( ( void* )column, R_NilValue, data ) );
+
+    switch( column->type )
+    {
+        case GAR_FRAME_COLUMN_REAL:
+            ret = R_new_altrep( gar_frame_real_class, ptr, R_NilValue );
+            break;
+        case GAR_FRAME_COLUMN_LABEL:
+            if( !factor )
+            {
+                ret = R_new_altrep( gar_frame_string_class, ptr, R_NilValue );
+                break;
+            }
+            ret = PROTECT( R_new_altrep( gar_frame_integer_class, ptr,
+                        R_NilValue ) );
+            setAttrib( ret, R_LevelsSymbol, R_ExternalPtrProtected( data ) );
+            SET_CLASS( ret, mkString( "factor" ) );
+            UNPROTECT( 1 );
+            break;
+        default:
+            ret = R_new_altrep( gar_frame_integer_class, ptr, R_NilValue );
+            break;
+    }
+    UNPROTECT( 1 );
+
+    return ret;
+}
+
+/******************************************************************************/
+static void* gar_frame_column_dataptr( SEXP x, Rboolean writeable )
+{
+    SEXP values = R_altrep_data2( x );
+
+    if( values == R_NilValue )
+    {
+        values = PROTECT( gar_frame_column_materialise( x ) );
+        R_set_altrep_data2( x, values );
+        UNPROTECT( 1 );
+    }
+
+    return DATAPTR( values );
+}
+
+/******************************************************************************/
+static const void* gar_frame_column_dataptr_or_null( SEXP x )
+{
+    SEXP values = R_altrep_data2( x );
+
+    if( values == R_NilValue )
+    {
+        return NULL;
+    }
+
+    return DATAPTR_RO( values );
+}
+
+/******************************************************************************/
+static SEXP gar_frame_column_duplicate( SEXP x, Rboolean deep )
+{
+    return gar_frame_column_materialise( x );
+}
+
+/******************************************************************************/
+static const gar_frame_column_t* gar_frame_column_get( SEXP x,
+        const gar_frame_data_t** data )
+{
+    SEXP ptr = R_altrep_data1( x );
+
+    *data = R_ExternalPtrAddr( R_ExternalPtrProtected( ptr ) );
+    return R_ExternalPtrAddr( ptr );
+}
+
+/******************************************************************************/
+static R_xlen_t gar_frame_column_length( SEXP x )
+{
+    const gar_frame_data_t* data;
+
+    gar_frame_column_get( x, &data );
+    return data->count;
+}
+
+/******************************************************************************/
+static SEXP gar_frame_column_levels( SEXP x )
+{
+    return R_ExternalPtrProtected( R_ExternalPtrProtected(
+                R_altrep_data1( x ) ) );
+}
+
+/******************************************************************************/
+static SEXP gar_frame_column_materialise( SEXP x )
+{
+    SEXP ret;
+    R_xlen_t i;
+    R_xlen_t len = gar_frame_column_length( x );
+
+    switch( TYPEOF( x ) )
+    {
+        case REALSXP:
+            ret = Rf_allocVector( REALSXP, len );
+            gar_frame_real_get_region( x, 0, len, REAL( ret ) );
+            break;
+        case INTSXP:
+            ret = Rf_allocVector( INTSXP, len );
+            gar_frame_integer_get_region( x, 0, len, INTEGER( ret ) );
+            break;
+        default:
+            ret = PROTECT( Rf_allocVector( STRSXP, len ) );
+            for( i = 0; i < len; i++ )
+            {
+                SET_STRING_ELT( ret, i, gar_frame_string_elt( x, i ) );
+            }
+            UNPROTECT( 1 );
+            break;
+    }
+
+    return ret;
+}
+
+/******************************************************************************/
+static R_xlen_t gar_frame_column_region( SEXP x, R_xlen_t start,
+        R_xlen_t n )
+{
+    R_xlen_t len = gar_frame_column_length( x );
+
+    if( start >= len )
+    {
+        return 0;
+    }
+
+    return ( n > len - start ) ? len - start : n;
+}
+
+/******************************************************************************/
+static SEXP gar_frame_create( const void* items, uint32_t count, size_t size,
+        const gar_frame_column_t* columns, uint32_t column_count, SEXP levels,
+        bool factor )
+{
+    SEXP df, names, ptr, rownames;
+    uint32_t i;
+    gar_frame_data_t* data;
+
+    data = malloc( sizeof( gar_frame_data_t ) );
+    if( data == NULL )
+    {
+        error( "failed to allocate memory for the data frame" );
+    }
+    data->items = NULL;
+    data->count = 0;
+    data->size = size;
+
+    ptr = PROTECT( R_MakeExternalPtr( data, R_NilValue, levels ) );
+    R_RegisterCFinalizerEx( ptr, gar_frame_data_finalise, TRUE );
+
+    if( count > 0 )
+    {
+        data->items = malloc( ( size_t )count * size );
+        if( data->items == NULL )
+        {
+            error( "failed to allocate memory for the data frame" );
+        }
+        memcpy( data->items, items, ( size_t )count * size );
+        data->count = count;
+    }
+
+    df = PROTECT( Rf_allocVector( VECSXP, column_count ) );
+    names = PROTECT( Rf_allocVector( STRSXP, column_count ) );
+    for( i = 0; i < column_count; i++ )
+    {
+        SET_VECTOR_ELT( df, i, gar_frame_column_create( ptr, &columns[i],
+                    factor ) );
+        SET_STRING_ELT( names, i, Rf_mkChar( columns[i].name ) );
+    }
+    setAttrib( df, R_NamesSymbol, names );
+    SET_CLASS( df, mkString( "data.frame" ) );
+
+    rownames = PROTECT( allocVector( INTSXP, 2 ) );
+    SET_INTEGER_ELT( rownames, 0, NA_INTEGER );
+    SET_INTEGER_ELT( rownames, 1, -count );
+    setAttrib( df, R_RowNamesSymbol, rownames );
+    UNPROTECT( 4 );
+
+    return df;
+}
+
+/******************************************************************************/
+static void gar_frame_data_finalise( SEXP ptr )
+{
+    gar_frame_data_t* data = R_ExternalPtrAddr( ptr );
+
+    if( data == NULL )
+    {
+        return;
+    }
+
+    free( data->items );
+    free( data );
+    R_ClearExternalPtr( ptr );
+}
+
+/******************************************************************************/
+SEXP gar_frame_fixations_create( gar_events_t* events, SEXP levels,
+        bool factor )
+{
+    return gar_frame_create( events->fixations, events->fixation_count,
+            sizeof( gar_fixation_item_t ), gar_frame_fixation_columns,
+            GAR_FRAME_COLUMN_COUNT( gar_frame_fixation_columns ), levels,
+            factor );
+}
+
+/******************************************************************************/
+void gar_frame_init( DllInfo* dll )
+{
+    R_altrep_class_t cls;
+
+    cls = R_make_altreal_class( "gar_real_column", "gar", dll );
+    R_set_altrep_Length_method( cls, gar_frame_column_length );
+    R_set_altrep_Duplicate_method( cls, gar_frame_column_duplicate );
+    R_set_altvec_Dataptr_method( cls, gar_frame_column_dataptr );
+    R_set_altvec_Dataptr_or_null_method( cls,
+            gar_frame_column_dataptr_or_null );
+    R_set_altreal_Elt_method( cls, gar_frame_real_elt );
+    R_set_altreal_Get_region_method( cls, gar_frame_real_get_region );
+    gar_frame_real_class = cls;
+
+    cls = R_make_altinteger_class( "gar_integer_column", "gar", dll );
+    R_set_altrep_Length_method( cls, gar_frame_column_length );
+    R_set_altrep_Duplicate_method( cls, gar_frame_column_duplicate );
+    R_set_altvec_Dataptr_method( cls, gar_frame_column_dataptr );
+    R_set_altvec_Dataptr_or_null_method( cls,
+            gar_frame_column_dataptr_or_null );
+    R_set_altinteger_Elt_method( cls, gar_frame_integer_elt );
+    R_set_altinteger_Get_region_method( cls, gar_frame_integer_get_region );
+    gar_frame_integer_class = cls;
+
+    cls = R_make_altstring_class( "gar_string_column", "gar", dll );
+    R_set_altrep_Length_method( cls, gar_frame_column_length );
+    R_set_altrep_Duplicate_method( cls, gar_frame_column_duplicate );
+    R_set_altvec_Dataptr_method( cls, gar_frame_column_dataptr );
+    R_set_altvec_Dataptr_or_null_method( cls,
+            gar_frame_column_dataptr_or_null );
+    R_set_altstring_Elt_method( cls, gar_frame_string_elt );
+    R_set_altstring_Set_elt_method( cls, gar_frame_string_set_elt );
+    gar_frame_string_class = cls;
+}
+
+/******************************************************************************/
+static int gar_frame_integer_elt( SEXP x, R_xlen_t i )
+{
+    int value;
+
+    gar_frame_integer_get_region( x, i, 1, &value );
+    return value;
+}
+
+/******************************************************************************/
+static R_xlen_t gar_frame_integer_get_region( SEXP x, R_xlen_t start,
+        R_xlen_t n, int* buf )
+{
+    R_xlen_t i;
+    const char* field;
+    const gar_frame_data_t* data;
+    const gar_frame_column_t* column;
+    SEXP values = R_altrep_data2( x );
+
+    n = gar_frame_column_region( x, start, n );
+    if( values != R_NilValue )
+    {
+        memcpy( buf, INTEGER( values ) + start, n * sizeof( int ) );
+        return n;
+    }
+
+    column = gar_frame_column_get( x, &data );
+    field = ( const char* )data->items + start * data->size + column->offset;
+    if( column->type == GAR_FRAME_COLUMN_LABEL )
+    {
+        for( i = 0; i < n; i++, field += data->size )
+        {
+            buf[i] = *( const uint32_t* )field + 1;
+        }
+    }
+    else
+    {
+        for( i = 0; i < n; i++, field += data->size )
+        {
+            buf[i] = *( const int32_t* )field;
+        }
+    }
+
+    return n;
+}
+
+/******************************************************************************/
+static double gar_frame_real_elt( SEXP x, R_xlen_t i )
+{
+    double value;
+
+    gar_frame_real_get_region( x, i, 1, &value );
+    return value;
+}
+
+/******************************************************************************/
+static R_xlen_t gar_frame_real_get_region( SEXP x, R_xlen_t start,
+        R_xlen_t n, double* buf )
+{
+    R_xlen_t i;
+    const char* field;
+    const gar_frame_data_t* data;
+    const gar_frame_column_t* column;
+    SEXP values = R_altrep_data2( x );
+
+    n = gar_frame_column_region( x, start, n );
+    if( values != R_NilValue )
+    {
+        memcpy( buf, REAL( values ) + start, n * sizeof( double ) );
+        return n;
+    }
+
+    column = gar_frame_column_get( x, &data );
+    field = ( const char* )data->items + start * data->size + column->offset;
+    for( i = 0; i < n; i++, field += data->size )
+    {
+        buf[i] = *( const double* )field;
+    }
+
+    return n;
+}
+
+/******************************************************************************/
+SEXP gar_frame_saccades_create( gar_events_t* events, SEXP levels,
+        bool factor )
+{
+    return gar_frame_create( events->saccades, events->saccade_count,
+            sizeof( gar_saccade_item_t ), gar_frame_saccade_columns,
+            GAR_FRAME_COLUMN_COUNT( gar_frame_saccade_columns ), levels,
+            factor );
+}
+
+/******************************************************************************/
+static SEXP gar_frame_string_elt( SEXP x, R_xlen_t i )
+{
+    const char* field;
+    const gar_frame_data_t* data;
+    const gar_frame_column_t* column;
+    SEXP values = R_altrep_data2( x );
+
+    if( values != R_NilValue )
+    {
+        return STRING_ELT( values, i );
+    }
+
+    column = gar_frame_column_get( x, &data );
+    field = ( const char* )data->items + i * data->size + column->offset;
+
+    return STRING_ELT( gar_frame_column_levels( x ),
+            *( const uint32_t* )field );
+}
+
+/******************************************************************************/
+static void gar_frame_string_set_elt( SEXP x, R_xlen_t i, SEXP v )
+{
+    gar_frame_column_dataptr( x, TRUE );
+    SET_STRING_ELT( R_altrep_data2( x ), i, v );
+}
@@ -0,0 +1,127 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef GAR_FRAME_H
+#define GAR_FRAME_H
+
+#include <Rinternals.h>
+#include <R_ext/Rdynload.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "gar_batch.h"
+
+/** The type of a lazy data frame column. */
+typedef enum gar_frame_column_type_e gar_frame_column_type_t;
+/** The description of a lazy data frame column. */
+typedef struct gar_frame_column_s gar_frame_column_t;
+/** A copy of the event items a lazy data frame is backed by. */
+typedef struct gar_frame_data_s gar_frame_data_t;
+
+/** The type of a lazy data frame column. */
+enum gar_frame_column_type_e
+{
+    /** A double field, exposed as numeric vector. */
+    GAR_FRAME_COLUMN_REAL,
+    /** An int32_t field, exposed as integer vector. */
+    GAR_FRAME_COLUMN_INTEGER,
+    /** A uint32_t label ID field, exposed as factor or character vector. */
+    GAR_FRAME_COLUMN_LABEL
+};
+
+/**
+ * The description of a lazy data frame column. A column exposes one field of
+ * each event item of the frame.
+ */
+struct gar_frame_column_s
+{
+    /** The name of the column. */
+    const char* name;
+    /** The type of the column. */
+    gar_frame_column_type_t type;
+    /** The byte offset of the field within an event item. */
+    size_t offset;
+};
+
+/**
+ * A copy of the event items a lazy data frame is backed by. The copy is
+ * owned by an R external pointer and is released with the last column of
+ * the frame which refers to it.
+ */
+struct gar_frame_data_s
+{
+    /** The event items. */
+    void* items;
+    /** The number of event items. */
+    uint32_t count;
+    /** The size of one event item in bytes. */
+    size_t size;
+};
+
+/**
+ * Create a lazy data frame holding AOI analysis entries. See
+ * gar_frame_fixations_create() for details.
+ *
+ * @param events
+ *  A pointer to the event list holding the AOI analysis entries.
+ * @param levels
+ *  The AOI names where the index corresponds to the AOI name ID.
+ * @param factor
+ *  True if the AOI name column is to be created as factor, false if it is to
+ *  be created as character vector.
+ * @return
+ *  The data frame.
+ */
+SEXP gar_frame_analyses_create( gar_events_t* events, SEXP levels,
+        bool factor );
+
+/**
+ * Create a lazy data frame holding fixations. The fixations are copied at
+ * once and each column of the frame is an ALTREP vector which reads its
+ * elements from the copy. A column is only converted to a regular R vector
+ * if R requests a pointer to its data. Columns which are never accessed
+ * cost neither memory nor time.
+ *
+ * @param events
+ *  A pointer to the event list holding the fixations.
+ * @param levels
+ *  The label strings where the index corresponds to the label ID.
+ * @param factor
+ *  True if the label column is to be created as factor, false if it is to be
+ *  created as character vector.
+ * @return
+ *  The data frame.
+ */
+SEXP gar_frame_fixations_create( gar_events_t* events, SEXP levels,
+        bool factor );
+
+/**
+ * Register the ALTREP classes of the lazy data frame columns. This must be
+ * called once when the shared library is loaded.
+ *
+ * @param dll
+ *  The DLL info of the package.
+ */
+void gar_frame_init( DllInfo* dll );
+
+/**
+ * Create a lazy data frame holding saccades. See
+ * gar_frame_fixations_create() for details.
+ *
+ * @param events
+ *  A pointer to the event list holding the saccades.
+ * @param levels
+ *  The label strings where the index corresponds to the label ID.
+ * @param factor
+ *  True if the label column is to be created as factor, false if it is to be
+ *  created as character vector.
+ * @return
+ *  The data frame.
+ */
+SEXP gar_frame_saccades_create( gar_events_t* events, SEXP levels,
+        bool factor );
+
+#endif
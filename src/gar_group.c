@@ -0,0 +1,86 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include "gar_group.h"
+#include "gar_thread.h"
+#include <stdlib.h>
+
+/**
+ * Parse one group with a new gac handler.
+ *
+ * @param data
+ *  A pointer to the group set.
+ * @param idx
+ *  The index of the group to parse.
+ * @return
+ *  True on success, false on failure.
+ */
+static bool gar_group_parse_job( void* data, uint32_t idx );
+
+/******************************************************************************/
+bool gar_group_parse( gar_group_t* group, uint32_t thread_count )
+{
+    return gar_thread_run( gar_group_parse_job, group, group->group_count,
+            thread_count );
+}
+
+/******************************************************************************/
+static bool gar_group_parse_job( void* data, uint32_t idx )
+{
+    uint32_t i;
+    uint32_t end;
+    bool res;
+    gac_t* gac;
+    gar_stimuli_t stimuli;
+    gar_batch_t batch;
+    gar_batch_buffer_t* buffer;
+    gar_group_t* group = data;
+    gar_events_t* events = &group->events[idx];
+
+    if( !gar_events_init( events, NULL ) )
+    {
+        return false;
+    }
+
+    buffer = malloc( sizeof( gar_batch_buffer_t ) );
+    if( buffer == NULL )
+    {
+        return false;
+    }
+
+    gac = gar_handler_gac_create( group->h, &stimuli );
+    if( gac == NULL )
+    {
+        free( buffer );
+        return false;
+    }
+
+    gar_batch_buffer_attach( &batch, buffer,
+            group->samples.sx != NULL && group->samples.sy != NULL,
+            group->samples.labels );
+    batch.screen = group->samples.screen;
+
+    res = true;
+    end = group->offsets[idx + 1];
+    for( i = group->offsets[idx]; res && i < end; i += batch.count )
+    {
+        batch.count = ( end - i < GAR_BATCH_SIZE ) ? end - i : GAR_BATCH_SIZE;
+        gar_batch_buffer_gather( buffer, &group->samples, &group->order[i],
+                batch.count );
+        res = gar_batch_parse( gac, &stimuli, &batch, events );
+    }
+
+    if( res )
+    {
+        res = gar_batch_finalise( gac, &stimuli, events );
+    }
+
+    gar_stimuli_destroy( &stimuli );
+    gac_destroy( gac );
+    free( buffer );
+
+    return res;
+}
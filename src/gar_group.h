@@ -0,0 +1,54 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef GAR_GROUP_H
+#define GAR_GROUP_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "gar_batch.h"
+#include "gar_handler.h"
+
+/** A set of sample groups which are parsed independently of each other. */
+typedef struct gar_group_s gar_group_t;
+
+/**
+ * A set of sample groups. Each group is parsed by its own gac handler which
+ * is configured like the gac handler of the R handler.
+ */
+struct gar_group_s
+{
+    /** The handler holding the configuration to use for each group. */
+    gar_handler_t* h;
+    /** The complete input sample columns of all groups. */
+    gar_batch_t samples;
+    /** The sample indices ordered by group. Within a group the input order
+     * is kept. */
+    const uint32_t* order;
+    /** The offsets of the groups in the order list. This holds one more
+     * element than there are groups. */
+    const uint32_t* offsets;
+    /** The number of groups. */
+    uint32_t group_count;
+    /** The list of event lists, one per group. It must be zero-initialised
+     * and is initialised while parsing. */
+    gar_events_t* events;
+};
+
+/**
+ * Parse all groups in parallel. The events of each group are stored in the
+ * event list of the group. This function does not use the R API.
+ *
+ * @param group
+ *  A pointer to the group set to parse.
+ * @param thread_count
+ *  The number of worker threads.
+ * @return
+ *  True on success, false on failure.
+ */
+bool gar_group_parse( gar_group_t* group, uint32_t thread_count );
+
+#endif
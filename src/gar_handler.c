@@ -0,0 +1,757 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include "gar_handler.h"
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * Append an AOI definition to the handler and add the AOI to the gac handler.
+ * The points of the AOI must have been written to the point buffer after the
+ * last point in use, the space for the definition must have been reserved
+ * with gar_handler_reserve().
+ *
+ * @param h
+ *  A pointer to the handler.
+ * @param label
+ *  An optional label describing the AOI. It is owned by the handler.
+ * @param stimulus
+ *  The ID of the stimulus the AOI belongs to.
+ * @param is_rect
+ *  True if the points describe a rectangle, false otherwise.
+ * @param count
+ *  The number of AOI points.
+ * @return
+ *  True on success, false on failure. On failure the AOI is not added and
+ *  the label is freed.
+ */
+static bool gar_handler_add_aoi( gar_handler_t* h, char* label,
+        uint32_t stimulus, bool is_rect, uint32_t count );
+
+/**
+ * Allocate a handler around a screen and AOI configuration.
+ *
+ * @param params
+ *  A pointer to the filter parameters.
+ * @param geometry
+ *  A pointer to the screen and AOI configuration. On success, the handler
+ *  holds a reference to it.
+ * @return
+ *  The allocated handler or NULL on failure.
+ */
+static gar_handler_t* gar_handler_alloc( gac_filter_parameter_t* params,
+        gar_geometry_t* geometry );
+
+/**
+ * Add the AOI of an AOI definition to a gac handler.
+ *
+ * @param gac
+ *  A pointer to the gac handler.
+ * @param stimuli
+ *  A pointer to the AOI sets of the gac handler.
+ * @param geometry
+ *  A pointer to the configuration holding the AOI definition.
+ * @param def
+ *  A pointer to the AOI definition.
+ * @return
+ *  True on success, false on failure.
+ */
+static bool gar_handler_gac_add_aoi( gac_t* gac, gar_stimuli_t* stimuli,
+        gar_geometry_t* geometry, gar_aoi_def_t* def );
+
+/**
+ * Make sure the screen and AOI configuration of a handler is not shared with
+ * any other handler by replacing a shared configuration with a deep copy.
+ *
+ * @param h
+ *  A pointer to the handler.
+ * @return
+ *  True on success, false on failure.
+ */
+static bool gar_handler_geometry_detach( gar_handler_t* h );
+
+/**
+ * Release a reference to a screen and AOI configuration. The configuration
+ * is freed with its last reference.
+ *
+ * @param geometry
+ *  A pointer to the configuration.
+ */
+static void gar_handler_geometry_release( gar_geometry_t* geometry );
+
+/**
+ * Make sure the screen and AOI configuration of a handler is not shared and
+ * has space for further AOI definitions and points.
+ *
+ * @param h
+ *  A pointer to the handler.
+ * @param aoi_count
+ *  The number of AOI definitions to add.
+ * @param point_count
+ *  The number of points to add.
+ * @return
+ *  True on success, false on failure.
+ */
+static bool gar_handler_reserve( gar_handler_t* h, uint32_t aoi_count,
+        uint32_t point_count );
+
+/**
+ * Get the ID of a stimulus in the stimulus dictionary of a handler. The
+ * stimulus is added to the dictionary if it is not yet part of it. The
+ * configuration must not be shared.
+ *
+ * @param h
+ *  A pointer to the handler.
+ * @param stimulus
+ *  The stimulus or NULL.
+ * @return
+ *  The stimulus ID or GAR_LABEL_INVALID on failure.
+ */
+static uint32_t gar_handler_stimulus( gar_handler_t* h,
+        const char* stimulus );
+
+/**
+ * Remove the AOI definitions, points, and stimuli which were added to the
+ * configuration of a handler after the given counts. The configuration must
+ * not be shared. If the handler has a gac handler, it is released such that
+ * it is rebuilt from the remaining configuration on its next use (see
+ * gar_handler_gac()).
+ *
+ * @param h
+ *  A pointer to the handler.
+ * @param aoi_count
+ *  The number of AOI definitions to keep.
+ * @param point_count
+ *  The number of points to keep.
+ * @param stimulus_count
+ *  The number of stimuli to keep in the stimulus dictionary.
+ */
+static void gar_handler_truncate( gar_handler_t* h, uint32_t aoi_count,
+        uint32_t point_count, uint32_t stimulus_count );
+
+/******************************************************************************/
+static bool gar_handler_add_aoi( gar_handler_t* h, char* label,
+        uint32_t stimulus, bool is_rect, uint32_t count )
+{
+    gar_aoi_def_t* def;
+    gar_geometry_t* geometry = h->geometry;
+
+    def = &geometry->aois[geometry->aoi_count];
+    def->label = label;
+    def->is_rect = is_rect;
+    def->stimulus = stimulus;
+    def->offset = geometry->point_count;
+    def->count = count;
+
+    if( h->gac != NULL
+            && !gar_handler_gac_add_aoi( h->gac, &h->stimuli, geometry, def ) )
+    {
+        free( label );
+        return false;
+    }
+    geometry->aoi_count++;
+    geometry->point_count += count;
+
+    return true;
+}
+
+/******************************************************************************/
+bool gar_handler_add_aoi_points( gar_handler_t* h, const char* label,
+        const char* stimulus, const double* x, const double* y,
+        uint32_t count )
+{
+    uint32_t i, id;
+    double* points;
+    char* dup = NULL;
+
+    if( !gar_handler_reserve( h, 1, count ) )
+    {
+        return false;
+    }
+
+    id = gar_handler_stimulus( h, stimulus );
+    if( id == GAR_LABEL_INVALID )
+    {
+        return false;
+    }
+
+    if( label != NULL )
+    {
+        dup = strdup( label );
+        if( dup == NULL )
+        {
+            return false;
+        }
+    }
+
+    points = &h->geometry->points[2*h->geometry->point_count];
+    for( i = 0; i < count; i++ )
+    {
+        points[2*i] = x[i];
+        points[2*i + 1] = y[i];
+    }
+
+    return gar_handler_add_aoi( h, dup, id, false, count );
+}
+
+/******************************************************************************/
+bool gar_handler_add_aoi_rect( gar_handler_t* h, const char* label,
+        const char* stimulus, double x, double y, double width,
+        double height )
+{
+    uint32_t id;
+    double* points;
+    char* dup = NULL;
+
+    if( !gar_handler_reserve( h, 1, 2 ) )
+    {
+        return false;
+    }
+
+    id = gar_handler_stimulus( h, stimulus );
+    if( id == GAR_LABEL_INVALID )
+    {
+        return false;
+    }
+
+    if( label != NULL )
+    {
+        dup = strdup( label );
+        if( dup == NULL )
+        {
+            return false;
+        }
+    }
+
+    points = &h->geometry->points[2*h->geometry->point_count];
+    points[0] = x;
+    points[1] = y;
+    points[2] = width;
+    points[3] = height;
+
+    return gar_handler_add_aoi( h, dup, id, true, 2 );
+}
+
+/******************************************************************************/
+bool gar_handler_add_aois( gar_handler_t* h, const uint32_t* ids,
+        const double* x, const double* y, uint32_t count,
+        const char* const* labels, const char* const* stimuli,
+        uint32_t aoi_count )
+{
+    uint32_t i, k, start, aoi_start, point_start, stimulus_start;
+    uint32_t* offsets;
+    uint32_t* keys;
+    char** dups;
+    double* points;
+    bool res = true;
+
+    if( aoi_count == 0 )
+    {
+        return true;
+    }
+
+    if( !gar_handler_reserve( h, aoi_count, count ) )
+    {
+        return false;
+    }
+    aoi_start = h->geometry->aoi_count;
+    point_start = h->geometry->point_count;
+    stimulus_start = h->geometry->stimuli.count;
+
+    offsets = calloc( 2 * aoi_count + 1, sizeof( uint32_t ) );
+    dups = calloc( aoi_count, sizeof( char* ) );
+    if( offsets == NULL || dups == NULL )
+    {
+        free( offsets );
+        free( dups );
+        return false;
+    }
+    keys = &offsets[aoi_count + 1];
+
+    for( k = 0; res && k < aoi_count; k++ )
+    {
+        if( labels != NULL && labels[k] != NULL )
+        {
+            dups[k] = strdup( labels[k] );
+            res = dups[k] != NULL;
+        }
+        if( res )
+        {
+            keys[k] = gar_handler_stimulus( h,
+                    ( stimuli != NULL ) ? stimuli[k] : NULL );
+            res = keys[k] != GAR_LABEL_INVALID;
+        }
+    }
+    if( !res )
+    {
+        for( k = 0; k < aoi_count; k++ )
+        {
+            free( dups[k] );
+        }
+        free( offsets );
+        free( dups );
+        gar_labels_truncate( &h->geometry->stimuli, stimulus_start );
+        return false;
+    }
+
+    // counting sort of the points by AOI: offsets[k + 1] is first the size
+    // and then the start of AOI k, and after the scatter pass the end of AOI
+    // k, which is the start of AOI k + 1
+    for( i = 0; i < count; i++ )
+    {
+        offsets[ids[i] + 1]++;
+    }
+    start = 0;
+    for( k = 0; k < aoi_count; k++ )
+    {
+        start += offsets[k + 1];
+        offsets[k + 1] = start - offsets[k + 1];
+    }
+    points = &h->geometry->points[2*h->geometry->point_count];
+    for( i = 0; i < count; i++ )
+    {
+        k = offsets[ids[i] + 1]++;
+        points[2*k] = x[i];
+        points[2*k + 1] = y[i];
+    }
+
+    for( k = 0; res && k < aoi_count; k++ )
+    {
+        res = gar_handler_add_aoi( h, dups[k], keys[k], false,
+                offsets[k + 1] - offsets[k] );
+    }
+    // the labels of the AOIs after a failed one are not owned by the handler
+    for( ; k < aoi_count; k++ )
+    {
+        free( dups[k] );
+    }
+    // the AOIs before a failed one were already added to the gac handler
+    if( !res )
+    {
+        gar_handler_truncate( h, aoi_start, point_start, stimulus_start );
+    }
+
+    free( offsets );
+    free( dups );
+
+    return res;
+}
+
+/******************************************************************************/
+static gar_handler_t* gar_handler_alloc( gac_filter_parameter_t* params,
+        gar_geometry_t* geometry )
+{
+    gar_handler_t* h;
+
+    h = calloc( 1, sizeof( gar_handler_t ) );
+    if( h == NULL )
+    {
+        return NULL;
+    }
+
+    if( !gar_events_init( &h->stream, NULL ) )
+    {
+        free( h );
+        return NULL;
+    }
+
+    gar_arena_init( &h->arena, GAR_ARENA_BLOCK_SIZE );
+    if( !gar_events_init( &h->events, &h->arena ) )
+    {
+        gar_events_destroy( &h->stream );
+        free( h );
+        return NULL;
+    }
+
+    if( !gar_online_init( &h->online ) )
+    {
+        gar_events_destroy( &h->events );
+        gar_events_destroy( &h->stream );
+        free( h );
+        return NULL;
+    }
+    h->online.buffer = true;
+
+    h->geometry = geometry;
+    h->params = *params;
+    geometry->ref_count++;
+
+    return h;
+}
+
+/******************************************************************************/
+gar_handler_t* gar_handler_clone( gar_handler_t* h )
+{
+    return gar_handler_alloc( &h->params, h->geometry );
+}
+
+/******************************************************************************/
+gar_handler_t* gar_handler_create( gac_filter_parameter_t* params )
+{
+    gar_handler_t* h;
+    gar_geometry_t* geometry;
+
+    geometry = calloc( 1, sizeof( gar_geometry_t ) );
+    if( geometry == NULL )
+    {
+        return NULL;
+    }
+
+    if( !gar_labels_init( &geometry->stimuli, NULL ) )
+    {
+        free( geometry );
+        return NULL;
+    }
+
+    h = gar_handler_alloc( params, geometry );
+    if( h == NULL )
+    {
+        gar_labels_destroy( &geometry->stimuli );
+        free( geometry );
+        return NULL;
+    }
+
+    // the first gac handler is created right away to validate the parameters
+    if( gar_handler_gac( h ) == NULL )
+    {
+        gar_handler_destroy( h );
+        return NULL;
+    }
+    gac_get_filter_parameter( h->gac, &h->params );
+
+    return h;
+}
+
+/******************************************************************************/
+void gar_handler_destroy( gar_handler_t* h )
+{
+    if( h == NULL )
+    {
+        return;
+    }
+
+    gar_handler_geometry_release( h->geometry );
+    if( h->gac != NULL )
+    {
+        gar_stimuli_destroy( &h->stimuli );
+        gac_destroy( h->gac );
+    }
+    gar_events_destroy( &h->stream );
+    gar_events_destroy( &h->events );
+    gar_online_destroy( &h->online );
+    gar_arena_destroy( &h->arena );
+    free( h );
+}
+
+/******************************************************************************/
+gac_t* gar_handler_gac( gar_handler_t* h )
+{
+    if( h->gac == NULL )
+    {
+        h->gac = gar_handler_gac_create( h, &h->stimuli );
+    }
+
+    return h->gac;
+}
+
+/******************************************************************************/
+gac_t* gar_handler_gac_create( gar_handler_t* h, gar_stimuli_t* stimuli )
+{
+    gac_filter_parameter_t params = h->params;
+
+    return gar_handler_gac_create_params( h, &params, stimuli );
+}
+
+/******************************************************************************/
+gac_t* gar_handler_gac_create_params( gar_handler_t* h,
+        gac_filter_parameter_t* params, gar_stimuli_t* stimuli )
+{
+    uint32_t i;
+    gac_t* gac;
+    gar_geometry_t* geometry = h->geometry;
+
+    gar_stimuli_init( stimuli, &geometry->stimuli );
+    gac = gac_create( params );
+    if( gac == NULL )
+    {
+        return NULL;
+    }
+
+    if( geometry->has_screen )
+    {
+        gac_set_screen( gac, geometry->screen[0], geometry->screen[1],
+                geometry->screen[2], geometry->screen[3], geometry->screen[4],
+                geometry->screen[5], geometry->screen[6], geometry->screen[7],
+                geometry->screen[8] );
+    }
+
+    for( i = 0; i < geometry->aoi_count; i++ )
+    {
+        if( !gar_handler_gac_add_aoi( gac, stimuli, geometry,
+                    &geometry->aois[i] ) )
+        {
+            gar_stimuli_destroy( stimuli );
+            gac_destroy( gac );
+            return NULL;
+        }
+    }
+
+    return gac;
+}
+
+/******************************************************************************/
+static bool gar_handler_gac_add_aoi( gac_t* gac, gar_stimuli_t* stimuli,
+        gar_geometry_t* geometry, gar_aoi_def_t* def )
+{
+    uint32_t i;
+    bool res;
+    gac_aoi_t aoi;
+    const double* points = &geometry->points[2*def->offset];
+
+    if( !gac_aoi_init( &aoi, def->label ) )
+    {
+        return false;
+    }
+
+    if( def->is_rect )
+    {
+        res = gac_aoi_add_rect( &aoi, points[0], points[1], points[2],
+                points[3] );
+    }
+    else
+    {
+        res = true;
+        for( i = 0; res && i < def->count; i++ )
+        {
+            res = gac_aoi_add_point( &aoi, points[2*i], points[2*i + 1] );
+        }
+    }
+
+    // the AOI is only owned by the AOI set if it was added
+    if( !res || !gar_stimuli_add_aoi( stimuli, gac, def->stimulus, &aoi ) )
+    {
+        gac_aoi_destroy( &aoi );
+        return false;
+    }
+
+    return true;
+}
+
+/******************************************************************************/
+static bool gar_handler_geometry_detach( gar_handler_t* h )
+{
+    uint32_t i;
+    gar_aoi_def_t* def;
+    gar_geometry_t* src = h->geometry;
+    gar_geometry_t* geometry;
+
+    if( src->ref_count == 1 )
+    {
+        return true;
+    }
+
+    geometry = calloc( 1, sizeof( gar_geometry_t ) );
+    if( geometry == NULL )
+    {
+        return false;
+    }
+    geometry->ref_count = 1;
+    if( !gar_labels_init( &geometry->stimuli, NULL ) )
+    {
+        free( geometry );
+        return false;
+    }
+    // the IDs are assigned in order of insertion and hence stay the same
+    for( i = 1; i < src->stimuli.count; i++ )
+    {
+        if( gar_labels_intern( &geometry->stimuli, src->stimuli.items[i] )
+                == GAR_LABEL_INVALID )
+        {
+            gar_handler_geometry_release( geometry );
+            return false;
+        }
+    }
+    geometry->has_screen = src->has_screen;
+    memcpy( geometry->screen, src->screen, 9 * sizeof( double ) );
+    geometry->has_projection = src->has_projection;
+    geometry->projection = src->projection;
+
+    geometry->aois = malloc( ( src->aoi_count > 0 ? src->aoi_count : 1 )
+            * sizeof( gar_aoi_def_t ) );
+    geometry->points = malloc( 2 * ( src->point_count > 0
+                ? src->point_count : 1 ) * sizeof( double ) );
+    if( geometry->aois == NULL || geometry->points == NULL )
+    {
+        gar_handler_geometry_release( geometry );
+        return false;
+    }
+    geometry->aoi_size = src->aoi_count > 0 ? src->aoi_count : 1;
+    geometry->point_size = src->point_count > 0 ? src->point_count : 1;
+    memcpy( geometry->points, src->points,
+            2 * src->point_count * sizeof( double ) );
+    geometry->point_count = src->point_count;
+
+    for( i = 0; i < src->aoi_count; i++ )
+    {
+        def = &geometry->aois[i];
+        *def = src->aois[i];
+        if( def->label != NULL )
+        {
+            def->label = strdup( def->label );
+            if( def->label == NULL )
+            {
+                gar_handler_geometry_release( geometry );
+                return false;
+            }
+        }
+        geometry->aoi_count++;
+    }
+
+    gar_handler_geometry_release( src );
+    h->geometry = geometry;
+    h->stimuli.keys = &geometry->stimuli;
+
+    return true;
+}
+
+/******************************************************************************/
+static void gar_handler_geometry_release( gar_geometry_t* geometry )
+{
+    uint32_t i;
+
+    if( --geometry->ref_count > 0 )
+    {
+        return;
+    }
+
+    for( i = 0; i < geometry->aoi_count; i++ )
+    {
+        free( geometry->aois[i].label );
+    }
+    free( geometry->aois );
+    free( geometry->points );
+    gar_labels_destroy( &geometry->stimuli );
+    free( geometry );
+}
+
+/******************************************************************************/
+const gar_screen_t* gar_handler_get_projection( gar_handler_t* h )
+{
+    return h->geometry->has_projection ? &h->geometry->projection : NULL;
+}
+
+/******************************************************************************/
+static bool gar_handler_reserve( gar_handler_t* h, uint32_t aoi_count,
+        uint32_t point_count )
+{
+    uint32_t size;
+    gar_aoi_def_t* aois;
+    double* points;
+    gar_geometry_t* geometry;
+
+    if( !gar_handler_geometry_detach( h ) )
+    {
+        return false;
+    }
+    geometry = h->geometry;
+
+    if( aoi_count > geometry->aoi_size - geometry->aoi_count )
+    {
+        size = geometry->aoi_size + 8;
+        if( size < geometry->aoi_count + aoi_count )
+        {
+            size = geometry->aoi_count + aoi_count;
+        }
+        aois = realloc( geometry->aois, size * sizeof( gar_aoi_def_t ) );
+        if( aois == NULL )
+        {
+            return false;
+        }
+        geometry->aois = aois;
+        geometry->aoi_size = size;
+    }
+
+    if( point_count > geometry->point_size - geometry->point_count
+            || geometry->points == NULL )
+    {
+        size = 2 * geometry->point_size;
+        if( size < geometry->point_count + point_count )
+        {
+            size = geometry->point_count + point_count;
+        }
+        if( size < 8 )
+        {
+            size = 8;
+        }
+        points = realloc( geometry->points, 2 * size * sizeof( double ) );
+        if( points == NULL )
+        {
+            return false;
+        }
+        geometry->points = points;
+        geometry->point_size = size;
+    }
+
+    return true;
+}
+
+/******************************************************************************/
+bool gar_handler_set_screen( gar_handler_t* h, const double* screen,
+        bool project )
+{
+    gar_geometry_t* geometry;
+
+    if( !gar_handler_geometry_detach( h ) )
+    {
+        return false;
+    }
+    geometry = h->geometry;
+
+    memcpy( geometry->screen, screen, 9 * sizeof( double ) );
+    geometry->has_screen = true;
+    geometry->has_projection = project
+        && gar_screen_init( &geometry->projection, screen );
+
+    if( h->gac != NULL )
+    {
+        gac_set_screen( h->gac, screen[0], screen[1], screen[2],
+                screen[3], screen[4], screen[5],
+                screen[6], screen[7], screen[8] );
+    }
+
+    return true;
+}
+
+/******************************************************************************/
+static uint32_t gar_handler_stimulus( gar_handler_t* h,
+        const char* stimulus )
+{
+    return gar_labels_intern( &h->geometry->stimuli, stimulus );
+}
+
+/******************************************************************************/
+static void gar_handler_truncate( gar_handler_t* h, uint32_t aoi_count,
+        uint32_t point_count, uint32_t stimulus_count )
+{
+    uint32_t i;
+    gar_geometry_t* geometry = h->geometry;
+
+    for( i = aoi_count; i < geometry->aoi_count; i++ )
+    {
+        free( geometry->aois[i].label );
+    }
+    geometry->aoi_count = aoi_count;
+    geometry->point_count = point_count;
+    gar_labels_truncate( &geometry->stimuli, stimulus_count );
+
+    // libgac cannot remove AOIs from its collections
+    if( h->gac != NULL )
+    {
+        gar_stimuli_destroy( &h->stimuli );
+        gac_destroy( h->gac );
+        h->gac = NULL;
+    }
+}
@@ -0,0 +1,307 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef GAR_HANDLER_H
+#define GAR_HANDLER_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "gac.h"
+#include "gar_arena.h"
+#include "gar_batch.h"
+#include "gar_labels.h"
+#include "gar_online.h"
+#include "gar_stimuli.h"
+
+/** The gaze analysis handler of the R package. */
+typedef struct gar_handler_s gar_handler_t;
+/** The definition of an AOI as it was added to the handler. */
+typedef struct gar_aoi_def_s gar_aoi_def_t;
+/** The screen and AOI configuration of a handler. */
+typedef struct gar_geometry_s gar_geometry_t;
+
+/**
+ * The definition of an AOI. It is kept in order to configure further gac
+ * handlers the same way as the gac handler of the R handler.
+ */
+struct gar_aoi_def_s
+{
+    /** The optional label of the AOI. */
+    char* label;
+    /** True if the AOI was defined as rectangle, false otherwise. */
+    bool is_rect;
+    /** The ID of the stimulus the AOI belongs to in the stimulus dictionary
+     * of the configuration. */
+    uint32_t stimulus;
+    /** The index of the first point of the AOI in the point buffer of the
+     * configuration. For rectangles the two points hold x, y, width, and
+     * height. */
+    uint32_t offset;
+    /** The number of points. */
+    uint32_t count;
+};
+
+/**
+ * The screen and AOI configuration of a handler. It is shared by a handler
+ * and its clones and is not modified while it is shared: a handler which
+ * changes a shared configuration first detaches its own copy.
+ */
+struct gar_geometry_s
+{
+    /** The number of handlers referencing the configuration. */
+    uint32_t ref_count;
+    /** True if the screen position was configured, false otherwise. */
+    bool has_screen;
+    /** The screen position: top left, top right, and bottom left corner. */
+    double screen[9];
+    /** True if the screen corners span a plane and the screen points are
+     * computed block-wise by the wrapper, false otherwise. */
+    bool has_projection;
+    /** The precomputed basis of the screen to compute screen points. */
+    gar_screen_t projection;
+    /** The list of AOI definitions. */
+    gar_aoi_def_t* aois;
+    /** The number of AOI definitions. */
+    uint32_t aoi_count;
+    /** The number of allocated AOI definitions. */
+    uint32_t aoi_size;
+    /** The interleaved x and y coordinates of the points of all AOIs. */
+    double* points;
+    /** The number of points. */
+    uint32_t point_count;
+    /** The number of allocated points. */
+    uint32_t point_size;
+    /** The dictionary of the stimuli AOIs were added under. The blank label
+     * stands for the AOIs without a stimulus. */
+    gar_labels_t stimuli;
+};
+
+/**
+ * The gaze analysis handler of the R package. It holds the gac handler and
+ * a copy of its configuration.
+ */
+struct gar_handler_s
+{
+    /** The gac handler. It is created on first use (see gar_handler_gac())
+     * such that clones which are never parsed with cost no gac handler. */
+    gac_t* gac;
+    /** The AOI sets of the gac handler. */
+    gar_stimuli_t stimuli;
+    /** The filter parameters of the gac handler. */
+    gac_filter_parameter_t params;
+    /** The screen and AOI configuration, possibly shared with clones. */
+    gar_geometry_t* geometry;
+    /** The events of a chunked parse. The label dictionaries persist across
+     * chunks such that the labels passed to the gac handler stay valid. */
+    gar_events_t stream;
+    /** The arena the labels of a single parse call are drawn from. */
+    gar_arena_t arena;
+    /** The events of a single parse call. They are reset at the end of each
+     * call such that repeated calls reuse the same memory. */
+    gar_events_t events;
+    /** The online parser of samples pushed with gar_push(). Its events are
+     * buffered until they are polled. */
+    gar_online_t online;
+    /** The accumulated parser statistics of all parse calls. */
+    gar_stats_t stats;
+};
+
+/**
+ * Add a list of AOIs defined by points to the handler. The points of all
+ * AOIs are given as one list where each point references its AOI by index.
+ * The points of an AOI need not be consecutive; they are collected in the
+ * order they appear. Either all AOIs are added or none: on failure the AOI
+ * definitions and the stimuli added by the call are removed again. If some
+ * of the AOIs were already added to the gac handler, the gac handler is
+ * released and rebuilt from the configuration on its next use, which drops
+ * its stream state (see gar_handler_gac()).
+ *
+ * @param h
+ *  A pointer to the handler.
+ * @param ids
+ *  The index of the AOI of each point, between 0 and `aoi_count - 1`.
+ * @param x
+ *  The normalized x coordinates of the AOI points.
+ * @param y
+ *  The normalized y coordinates of the AOI points.
+ * @param count
+ *  The number of AOI points.
+ * @param labels
+ *  The optional labels of the AOIs. This may be NULL and may hold NULL
+ *  entries.
+ * @param stimuli
+ *  The optional stimuli of the AOIs. This may be NULL and may hold NULL
+ *  entries (see gar_handler_add_aoi_points()).
+ * @param aoi_count
+ *  The number of AOIs.
+ * @return
+ *  True on success, false on failure.
+ */
+bool gar_handler_add_aois( gar_handler_t* h, const uint32_t* ids,
+        const double* x, const double* y, uint32_t count,
+        const char* const* labels, const char* const* stimuli,
+        uint32_t aoi_count );
+
+/**
+ * Add an AOI defined by points to the handler.
+ *
+ * @param h
+ *  A pointer to the handler.
+ * @param label
+ *  An optional label describing the AOI.
+ * @param stimulus
+ *  The optional stimulus the AOI belongs to. The AOI is only analysed for
+ *  fixations with the stimulus as sample label. AOIs without a stimulus are
+ *  analysed for all fixations whose label has no AOIs of its own.
+ * @param x
+ *  The normalized x coordinates of the AOI points.
+ * @param y
+ *  The normalized y coordinates of the AOI points.
+ * @param count
+ *  The number of AOI points.
+ * @return
+ *  True on success, false on failure.
+ */
+bool gar_handler_add_aoi_points( gar_handler_t* h, const char* label,
+        const char* stimulus, const double* x, const double* y,
+        uint32_t count );
+
+/**
+ * Add an AOI rectangle to the handler.
+ *
+ * @param h
+ *  A pointer to the handler.
+ * @param label
+ *  An optional label describing the AOI.
+ * @param stimulus
+ *  The optional stimulus the AOI belongs to (see
+ *  gar_handler_add_aoi_points()).
+ * @param x
+ *  The normalized x coordinate of the top left corner.
+ * @param y
+ *  The normalized y coordinate of the top left corner.
+ * @param width
+ *  The normalized width of the AOI.
+ * @param height
+ *  The normalized height of the AOI.
+ * @return
+ *  True on success, false on failure.
+ */
+bool gar_handler_add_aoi_rect( gar_handler_t* h, const char* label,
+        const char* stimulus, double x, double y, double width,
+        double height );
+
+/**
+ * Allocate a new handler which shares the filter parameters, the screen, and
+ * the AOIs of another handler. The screen and AOI configuration is shared
+ * with the original handler instead of being copied. This is not a copy of
+ * the handler: none of its stream state is copied (the sample window, an
+ * open trial, the AOI analysis progress, and the labels of the gac handler,
+ * as well as a chunked or online parse in progress). The gac handler of the
+ * new handler is only created on its first parse (see gar_handler_gac()).
+ *
+ * @param h
+ *  A pointer to the handler whose configuration is shared.
+ * @return
+ *  The allocated handler or NULL on failure.
+ */
+gar_handler_t* gar_handler_clone( gar_handler_t* h );
+
+/**
+ * Allocate a handler.
+ *
+ * @param params
+ *  A pointer to the filter parameters.
+ * @return
+ *  The allocated handler or NULL on failure.
+ */
+gar_handler_t* gar_handler_create( gac_filter_parameter_t* params );
+
+/**
+ * Destroy a handler.
+ *
+ * @param h
+ *  A pointer to the handler to destroy.
+ */
+void gar_handler_destroy( gar_handler_t* h );
+
+/**
+ * Get the gac handler of a handler. The gac handler is created from the
+ * configuration of the handler on first use.
+ *
+ * @param h
+ *  A pointer to the handler.
+ * @return
+ *  A pointer to the gac handler or NULL on failure.
+ */
+gac_t* gar_handler_gac( gar_handler_t* h );
+
+/**
+ * Allocate a new gac handler with the same filter parameters, screen, and
+ * AOIs as the gac handler of the handler. The sample window and the AOI
+ * analysis of the new gac handler are empty.
+ *
+ * This function does not use the R API and may be called from any thread.
+ *
+ * @param h
+ *  A pointer to the handler to replicate.
+ * @param stimuli
+ *  A pointer to the AOI sets of the new gac handler. They are initialised
+ *  from within the function and must be released with
+ *  gar_stimuli_destroy() before the gac handler is destroyed.
+ * @return
+ *  The allocated gac handler or NULL on failure.
+ */
+gac_t* gar_handler_gac_create( gar_handler_t* h, gar_stimuli_t* stimuli );
+
+/**
+ * Allocate a new gac handler with the given filter parameters and the same
+ * screen and AOIs as the gac handler of the handler. The sample window and
+ * the AOI analysis of the new gac handler are empty.
+ *
+ * This function does not use the R API and may be called from any thread.
+ *
+ * @param h
+ *  A pointer to the handler to replicate.
+ * @param params
+ *  A pointer to the filter parameters of the new gac handler.
+ * @param stimuli
+ *  A pointer to the AOI sets of the new gac handler (see
+ *  gar_handler_gac_create()).
+ * @return
+ *  The allocated gac handler or NULL on failure.
+ */
+gac_t* gar_handler_gac_create_params( gar_handler_t* h,
+        gac_filter_parameter_t* params, gar_stimuli_t* stimuli );
+
+/**
+ * Get the precomputed screen basis of the handler.
+ *
+ * @param h
+ *  A pointer to the handler.
+ * @return
+ *  A pointer to the screen basis or NULL if no valid screen is configured.
+ */
+const gar_screen_t* gar_handler_get_projection( gar_handler_t* h );
+
+/**
+ * Configure the screen position in 3d space.
+ *
+ * @param h
+ *  A pointer to the handler.
+ * @param screen
+ *  The x, y, and z coordinates of the top left, the top right, and the
+ *  bottom left screen corner.
+ * @param project
+ *  True if the screen points are to be computed block-wise with the
+ *  precomputed screen basis, false if libgac is to compute them per sample.
+ * @return
+ *  True on success, false on failure.
+ */
+bool gar_handler_set_screen( gar_handler_t* h, const double* screen,
+        bool project );
+
+#endif
@@ -8,26 +8,59 @@
 #include <Rinternals.h>
 #include <stdlib.h> // for NULL
 #include <R_ext/Rdynload.h>
+#include "gar_frame.h"
 
 /* .Call calls */
-extern SEXP gar_add_aoi_points( SEXP, SEXP, SEXP );
-extern SEXP gar_add_aoi_rectangle(SEXP, SEXP, SEXP, SEXP, SEXP, SEXP);
+extern SEXP gar_add_aoi_points( SEXP, SEXP, SEXP, SEXP );
+extern SEXP gar_add_aoi_rectangle(SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP);
+extern SEXP gar_add_aois(SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP);
+extern SEXP gar_benchmark(SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP);
+extern SEXP gar_clone(SEXP);
 extern SEXP gar_create(SEXP);
+extern SEXP gar_flush(SEXP, SEXP);
 extern SEXP gar_get_filter_parameter(SEXP);
 extern SEXP gar_get_filter_parameter_default();
+extern SEXP gar_get_latency(SEXP, SEXP);
+extern SEXP gar_get_stats(SEXP);
 extern SEXP gar_init();
-extern SEXP gar_parse(SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP);
-extern SEXP gar_set_screen(SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP);
+extern SEXP gar_parse(SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP);
+extern SEXP gar_parse_chunk(SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP);
+extern SEXP gar_parse_csv(SEXP, SEXP, SEXP, SEXP);
+extern SEXP gar_parse_grouped(SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP);
+extern SEXP gar_parse_sweep(SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP);
+extern SEXP gar_parse_trials(SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP);
+extern SEXP gar_poll(SEXP, SEXP, SEXP);
+extern SEXP gar_project_screen(SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP);
+extern SEXP gar_push(SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP);
+extern SEXP gar_reset_stats(SEXP);
+extern SEXP gar_set_screen(SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP);
+extern SEXP gar_synthesise(SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP);
 
 static const R_CallMethodDef CallEntries[] = {
-    {"gar_add_aoi_points",               (DL_FUNC) &gar_add_aoi_points,                3},
-    {"gar_add_aoi_rectangle",            (DL_FUNC) &gar_add_aoi_rectangle,             6},
+    {"gar_add_aoi_points",               (DL_FUNC) &gar_add_aoi_points,                4},
+    {"gar_add_aoi_rectangle",            (DL_FUNC) &gar_add_aoi_rectangle,             7},
+    {"gar_add_aois",                     (DL_FUNC) &gar_add_aois,                      7},
+    {"gar_benchmark",                    (DL_FUNC) &gar_benchmark,                     8},
+    {"gar_clone",                        (DL_FUNC) &gar_clone,                         1},
     {"gar_create",                       (DL_FUNC) &gar_create,                        1},
+    {"gar_flush",                        (DL_FUNC) &gar_flush,                         2},
     {"gar_get_filter_parameter",         (DL_FUNC) &gar_get_filter_parameter,          1},
     {"gar_get_filter_parameter_default", (DL_FUNC) &gar_get_filter_parameter_default,  0},
+    {"gar_get_latency",                  (DL_FUNC) &gar_get_latency,                   2},
+    {"gar_get_stats",                    (DL_FUNC) &gar_get_stats,                     1},
     {"gar_init",                         (DL_FUNC) &gar_init,                          0},
-    {"gar_parse",                        (DL_FUNC) &gar_parse,                        12},
-    {"gar_set_screen",                   (DL_FUNC) &gar_set_screen,                   10},
+    {"gar_parse",                        (DL_FUNC) &gar_parse,                        14},
+    {"gar_parse_chunk",                  (DL_FUNC) &gar_parse_chunk,                  13},
+    {"gar_parse_csv",                    (DL_FUNC) &gar_parse_csv,                     4},
+    {"gar_parse_grouped",                (DL_FUNC) &gar_parse_grouped,                15},
+    {"gar_parse_sweep",                  (DL_FUNC) &gar_parse_sweep,                  16},
+    {"gar_parse_trials",                 (DL_FUNC) &gar_parse_trials,                 15},
+    {"gar_poll",                         (DL_FUNC) &gar_poll,                          3},
+    {"gar_project_screen",               (DL_FUNC) &gar_project_screen,                7},
+    {"gar_push",                         (DL_FUNC) &gar_push,                         12},
+    {"gar_reset_stats",                  (DL_FUNC) &gar_reset_stats,                   1},
+    {"gar_set_screen",                   (DL_FUNC) &gar_set_screen,                   11},
+    {"gar_synthesise",                   (DL_FUNC) &gar_synthesise,                    7},
     {NULL, NULL, 0}
 };
 
@@ -35,4 +68,5 @@ void R_init_gar(DllInfo *dll)
 {
     R_registerRoutines(dll, NULL, CallEntries, NULL, NULL);
     R_useDynamicSymbols(dll, FALSE);
+    gar_frame_init(dll);
 }
@@ -0,0 +1,287 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include "gar_labels.h"
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * Compute the FNV-1a hash of a label string.
+ *
+ * @param label
+ *  The label string.
+ * @return
+ *  The hash value.
+ */
+static uint32_t gar_labels_hash( const char* label );
+
+/**
+ * Insert all labels of the dictionary into an empty hash table.
+ *
+ * @param labels
+ *  A pointer to the label dictionary.
+ * @param table
+ *  The hash table to fill. All slots must be empty.
+ * @param table_size
+ *  The number of hash table slots. This must be a power of two.
+ */
+static void gar_labels_fill( gar_labels_t* labels, uint32_t* table,
+        uint32_t table_size );
+
+/**
+ * Double the size of the hash table and re-insert all labels.
+ *
+ * @param labels
+ *  A pointer to the label dictionary.
+ * @return
+ *  True on success, false on failure.
+ */
+static bool gar_labels_rehash( gar_labels_t* labels );
+
+/******************************************************************************/
+void gar_labels_clear( gar_labels_t* labels )
+{
+    uint32_t i;
+
+    if( labels->arena == NULL )
+    {
+        for( i = 1; i < labels->count; i++ )
+        {
+            free( labels->items[i] );
+        }
+    }
+    memset( labels->table, 0, labels->table_size * sizeof( uint32_t ) );
+    labels->count = 1;
+    labels->last = GAR_LABEL_BLANK;
+}
+
+/******************************************************************************/
+void gar_labels_destroy( gar_labels_t* labels )
+{
+    uint32_t i;
+
+    for( i = 0; i < labels->count; i++ )
+    {
+        // the blank label is never drawn from the arena
+        if( i == GAR_LABEL_BLANK || labels->arena == NULL )
+        {
+            free( labels->items[i] );
+        }
+    }
+    free( labels->items );
+    free( labels->table );
+    memset( labels, 0, sizeof( gar_labels_t ) );
+}
+
+/******************************************************************************/
+static void gar_labels_fill( gar_labels_t* labels, uint32_t* table,
+        uint32_t table_size )
+{
+    uint32_t i, idx;
+    uint32_t mask = table_size - 1;
+
+    for( i = 1; i < labels->count; i++ )
+    {
+        idx = gar_labels_hash( labels->items[i] ) & mask;
+        while( table[idx] != 0 )
+        {
+            idx = ( idx + 1 ) & mask;
+        }
+        table[idx] = i + 1;
+    }
+}
+
+/******************************************************************************/
+uint32_t gar_labels_find( const gar_labels_t* labels, const char* label )
+{
+    uint32_t idx, mask, id;
+
+    if( label == NULL || *label == '\0' )
+    {
+        return GAR_LABEL_BLANK;
+    }
+
+    mask = labels->table_size - 1;
+    idx = gar_labels_hash( label ) & mask;
+    while( labels->table[idx] != 0 )
+    {
+        id = labels->table[idx] - 1;
+        if( strcmp( labels->items[id], label ) == 0 )
+        {
+            return id;
+        }
+        idx = ( idx + 1 ) & mask;
+    }
+
+    return GAR_LABEL_INVALID;
+}
+
+/******************************************************************************/
+const char* gar_labels_get( gar_labels_t* labels, uint32_t id )
+{
+    if( id == GAR_LABEL_BLANK || id >= labels->count )
+    {
+        return NULL;
+    }
+
+    return labels->items[id];
+}
+
+/******************************************************************************/
+static uint32_t gar_labels_hash( const char* label )
+{
+    uint32_t hash = 2166136261u;
+
+    while( *label != '\0' )
+    {
+        hash ^= ( unsigned char )*label++;
+        hash *= 16777619u;
+    }
+
+    return hash;
+}
+
+/******************************************************************************/
+bool gar_labels_init( gar_labels_t* labels, gar_arena_t* arena )
+{
+    memset( labels, 0, sizeof( gar_labels_t ) );
+    labels->arena = arena;
+
+    labels->size = 16;
+    labels->items = malloc( labels->size * sizeof( char* ) );
+    labels->table_size = 32;
+    labels->table = calloc( labels->table_size, sizeof( uint32_t ) );
+    if( labels->items == NULL || labels->table == NULL )
+    {
+        gar_labels_destroy( labels );
+        return false;
+    }
+
+    labels->items[GAR_LABEL_BLANK] = strdup( "" );
+    if( labels->items[GAR_LABEL_BLANK] == NULL )
+    {
+        gar_labels_destroy( labels );
+        return false;
+    }
+    labels->count = 1;
+    labels->last = GAR_LABEL_BLANK;
+
+    return true;
+}
+
+/******************************************************************************/
+uint32_t gar_labels_intern( gar_labels_t* labels, const char* label )
+{
+    uint32_t idx, mask, id;
+    char** items;
+    char* item;
+
+    if( label == NULL || *label == '\0' )
+    {
+        return GAR_LABEL_BLANK;
+    }
+
+    item = labels->items[labels->last];
+    if( item == label || strcmp( item, label ) == 0 )
+    {
+        return labels->last;
+    }
+
+    mask = labels->table_size - 1;
+    idx = gar_labels_hash( label ) & mask;
+    while( labels->table[idx] != 0 )
+    {
+        id = labels->table[idx] - 1;
+        if( strcmp( labels->items[id], label ) == 0 )
+        {
+            labels->last = id;
+            return id;
+        }
+        idx = ( idx + 1 ) & mask;
+    }
+
+    if( labels->count == labels->size )
+    {
+        items = realloc( labels->items, labels->size * 2 * sizeof( char* ) );
+        if( items == NULL )
+        {
+            return GAR_LABEL_INVALID;
+        }
+        labels->items = items;
+        labels->size *= 2;
+    }
+
+    if( labels->arena != NULL )
+    {
+        item = gar_arena_strdup( labels->arena, label );
+    }
+    else
+    {
+        item = strdup( label );
+    }
+    if( item == NULL )
+    {
+        return GAR_LABEL_INVALID;
+    }
+
+    id = labels->count;
+    labels->items[id] = item;
+    labels->count++;
+    labels->table[idx] = id + 1;
+    labels->last = id;
+
+    if( labels->count * 2 > labels->table_size && !gar_labels_rehash( labels ) )
+    {
+        return GAR_LABEL_INVALID;
+    }
+
+    return id;
+}
+
+/******************************************************************************/
+static bool gar_labels_rehash( gar_labels_t* labels )
+{
+    uint32_t* table;
+    uint32_t table_size = labels->table_size * 2;
+
+    table = calloc( table_size, sizeof( uint32_t ) );
+    if( table == NULL )
+    {
+        return false;
+    }
+
+    gar_labels_fill( labels, table, table_size );
+
+    free( labels->table );
+    labels->table = table;
+    labels->table_size = table_size;
+
+    return true;
+}
+
+/******************************************************************************/
+void gar_labels_truncate( gar_labels_t* labels, uint32_t count )
+{
+    uint32_t i;
+
+    if( count >= labels->count )
+    {
+        return;
+    }
+
+    if( labels->arena == NULL )
+    {
+        for( i = count; i < labels->count; i++ )
+        {
+            free( labels->items[i] );
+        }
+    }
+    labels->count = count;
+    labels->last = GAR_LABEL_BLANK;
+
+    memset( labels->table, 0, labels->table_size * sizeof( uint32_t ) );
+    gar_labels_fill( labels, labels->table, labels->table_size );
+}
@@ -0,0 +1,132 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef GAR_LABELS_H
+#define GAR_LABELS_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "gar_arena.h"
+
+/** The ID of the blank label. It is always present in a label dictionary. */
+#define GAR_LABEL_BLANK 0
+/** The ID returned if a label could not be interned. */
+#define GAR_LABEL_INVALID UINT32_MAX
+
+/** A dictionary mapping label strings to consecutive integer IDs. */
+typedef struct gar_labels_s gar_labels_t;
+
+/**
+ * A label dictionary. Labels are stored once and are referenced by their
+ * index. A hash table is used to look up the ID of a label string. The label
+ * strings are either allocated individually or drawn from an arena.
+ */
+struct gar_labels_s
+{
+    /** The list of label strings where the index is the label ID. */
+    char** items;
+    /** The number of labels in the dictionary. */
+    uint32_t count;
+    /** The number of allocated label slots. */
+    uint32_t size;
+    /** The hash table holding label IDs + 1 where 0 marks an empty slot. */
+    uint32_t* table;
+    /** The number of hash table slots. This is always a power of two. */
+    uint32_t table_size;
+    /** The ID of the label which was interned last. */
+    uint32_t last;
+    /** The arena the label strings are drawn from or NULL if they are
+     * allocated individually. */
+    gar_arena_t* arena;
+};
+
+/**
+ * Remove all labels except the blank label from the dictionary. The memory
+ * of the dictionary is kept. If the label strings are drawn from an arena,
+ * the arena needs to be reset by the caller.
+ *
+ * @param labels
+ *  A pointer to the label dictionary.
+ */
+void gar_labels_clear( gar_labels_t* labels );
+
+/**
+ * Release all memory held by the label dictionary.
+ *
+ * @param labels
+ *  A pointer to the label dictionary.
+ */
+void gar_labels_destroy( gar_labels_t* labels );
+
+/**
+ * Look up the ID of a label without adding it to the dictionary. The
+ * dictionary is not modified such that several threads may look up labels
+ * concurrently.
+ *
+ * @param labels
+ *  A pointer to the label dictionary.
+ * @param label
+ *  The label string. NULL and the empty string map to GAR_LABEL_BLANK.
+ * @return
+ *  The label ID or GAR_LABEL_INVALID if the label is not part of the
+ *  dictionary.
+ */
+uint32_t gar_labels_find( const gar_labels_t* labels, const char* label );
+
+/**
+ * Get the label string of a label ID.
+ *
+ * @param labels
+ *  A pointer to the label dictionary.
+ * @param id
+ *  The label ID.
+ * @return
+ *  The label string or NULL if the ID refers to the blank label.
+ */
+const char* gar_labels_get( gar_labels_t* labels, uint32_t id );
+
+/**
+ * Initialise a label dictionary which only holds the blank label.
+ *
+ * @param labels
+ *  A pointer to the label dictionary.
+ * @param arena
+ *  An optional arena to draw the label strings from. If NULL, each label
+ *  string is allocated individually.
+ * @return
+ *  True on success, false on failure.
+ */
+bool gar_labels_init( gar_labels_t* labels, gar_arena_t* arena );
+
+/**
+ * Get the ID of a label. The label is added to the dictionary if it is not
+ * yet part of it. A lookup of the same label as in the previous call is
+ * resolved without hashing.
+ *
+ * @param labels
+ *  A pointer to the label dictionary.
+ * @param label
+ *  The label string. NULL and the empty string map to GAR_LABEL_BLANK.
+ * @return
+ *  The label ID or GAR_LABEL_INVALID on failure.
+ */
+uint32_t gar_labels_intern( gar_labels_t* labels, const char* label );
+
+/**
+ * Remove all labels whose ID is not below a given count from the dictionary,
+ * i.e. the labels which were added last. The IDs of the remaining labels are
+ * kept. If the label strings are drawn from an arena, the strings of the
+ * removed labels stay in the arena until it is reset.
+ *
+ * @param labels
+ *  A pointer to the label dictionary.
+ * @param count
+ *  The number of labels to keep. This must be at least 1 such that the
+ *  blank label is kept.
+ */
+void gar_labels_truncate( gar_labels_t* labels, uint32_t count );
+
+#endif
@@ -0,0 +1,239 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include "gar_online.h"
+#include "gar_stats.h"
+#include <math.h>
+#include <string.h>
+
+/**
+ * Report all events which were added to the event list since the given
+ * counts, record their latencies, and drop them if the events are not
+ * buffered.
+ *
+ * @param online
+ *  A pointer to the online parser.
+ * @param fixation_count
+ *  The number of fixations before the last update.
+ * @param saccade_count
+ *  The number of saccades before the last update.
+ * @param analysis_count
+ *  The number of AOI analysis entries before the last update.
+ * @param arrival
+ *  The arrival time of the sample which triggered the update.
+ */
+static void gar_online_emit( gar_online_t* online, uint32_t fixation_count,
+        uint32_t saccade_count, uint32_t analysis_count, double arrival );
+
+/******************************************************************************/
+void gar_latency_add( gar_latency_t* latency, double seconds )
+{
+    uint32_t idx, exp;
+    uint64_t us;
+
+    if( seconds < 0 )
+    {
+        seconds = 0;
+    }
+    us = ( seconds * 1e6 < 2147483647.0 ) ? ( uint64_t )( seconds * 1e6 )
+        : 2147483647;
+
+    if( us < GAR_LATENCY_SUB_BIN_COUNT )
+    {
+        idx = us;
+    }
+    else
+    {
+        // exp >= 3, the three bits below the leading bit select the sub bin
+        exp = 63 - __builtin_clzll( us );
+        idx = ( exp - 2 ) * GAR_LATENCY_SUB_BIN_COUNT
+            + ( ( us >> ( exp - 3 ) ) & ( GAR_LATENCY_SUB_BIN_COUNT - 1 ) );
+    }
+
+    latency->bins[idx]++;
+    latency->count++;
+    latency->sum += seconds;
+    if( seconds > latency->max )
+    {
+        latency->max = seconds;
+    }
+}
+
+/******************************************************************************/
+double gar_latency_bin_lower( uint32_t idx )
+{
+    uint32_t exp, sub;
+
+    if( idx < GAR_LATENCY_SUB_BIN_COUNT )
+    {
+        return idx * 1e-6;
+    }
+
+    exp = idx / GAR_LATENCY_SUB_BIN_COUNT + 2;
+    sub = idx % GAR_LATENCY_SUB_BIN_COUNT;
+
+    return ldexp( GAR_LATENCY_SUB_BIN_COUNT + sub, exp - 3 ) * 1e-6;
+}
+
+/******************************************************************************/
+double gar_latency_bin_upper( uint32_t idx )
+{
+    uint32_t exp, sub;
+
+    if( idx < GAR_LATENCY_SUB_BIN_COUNT )
+    {
+        return ( idx + 1 ) * 1e-6;
+    }
+
+    exp = idx / GAR_LATENCY_SUB_BIN_COUNT + 2;
+    sub = idx % GAR_LATENCY_SUB_BIN_COUNT;
+
+    return ldexp( GAR_LATENCY_SUB_BIN_COUNT + sub + 1, exp - 3 ) * 1e-6;
+}
+
+/******************************************************************************/
+double gar_latency_quantile( gar_latency_t* latency, double q )
+{
+    uint32_t i;
+    uint64_t rank, sum;
+    double upper;
+
+    if( latency->count == 0 )
+    {
+        return NAN;
+    }
+
+    rank = ceil( q * latency->count );
+    if( rank < 1 )
+    {
+        rank = 1;
+    }
+
+    sum = 0;
+    for( i = 0; i < GAR_LATENCY_BIN_COUNT; i++ )
+    {
+        sum += latency->bins[i];
+        if( sum >= rank )
+        {
+            break;
+        }
+    }
+
+    upper = gar_latency_bin_upper( i );
+
+    return ( upper < latency->max ) ? upper : latency->max;
+}
+
+/******************************************************************************/
+void gar_latency_reset( gar_latency_t* latency )
+{
+    memset( latency, 0, sizeof( gar_latency_t ) );
+}
+
+/******************************************************************************/
+void gar_online_clear( gar_online_t* online )
+{
+    gar_events_clear( &online->events );
+}
+
+/******************************************************************************/
+void gar_online_destroy( gar_online_t* online )
+{
+    gar_events_destroy( &online->events );
+}
+
+/******************************************************************************/
+static void gar_online_emit( gar_online_t* online, uint32_t fixation_count,
+        uint32_t saccade_count, uint32_t analysis_count, double arrival )
+{
+    uint32_t i;
+    double latency;
+    gar_events_t* events = &online->events;
+
+    if( events->fixation_count == fixation_count
+            && events->saccade_count == saccade_count
+            && events->analysis_count == analysis_count )
+    {
+        return;
+    }
+
+    latency = gar_stats_now() - arrival;
+
+    for( i = saccade_count; i < events->saccade_count; i++ )
+    {
+        gar_latency_add( &online->latency, latency );
+        if( online->on_saccade != NULL )
+        {
+            online->on_saccade( online->data, events, &events->saccades[i] );
+        }
+    }
+    for( i = fixation_count; i < events->fixation_count; i++ )
+    {
+        gar_latency_add( &online->latency, latency );
+        if( online->on_fixation != NULL )
+        {
+            online->on_fixation( online->data, events, &events->fixations[i] );
+        }
+    }
+    for( i = analysis_count; i < events->analysis_count; i++ )
+    {
+        gar_latency_add( &online->latency, latency );
+        if( online->on_analysis != NULL )
+        {
+            online->on_analysis( online->data, events, &events->analyses[i] );
+        }
+    }
+
+    if( !online->buffer )
+    {
+        gar_events_clear( events );
+    }
+}
+
+/******************************************************************************/
+bool gar_online_finalise( gar_online_t* online, gac_t* h,
+        gar_stimuli_t* stimuli, double arrival )
+{
+    uint32_t fixation_count = online->events.fixation_count;
+    uint32_t saccade_count = online->events.saccade_count;
+    uint32_t analysis_count = online->events.analysis_count;
+
+    if( !gar_batch_finalise( h, stimuli, &online->events ) )
+    {
+        return false;
+    }
+    gar_online_emit( online, fixation_count, saccade_count, analysis_count,
+            arrival );
+
+    return true;
+}
+
+/******************************************************************************/
+bool gar_online_init( gar_online_t* online )
+{
+    memset( online, 0, sizeof( gar_online_t ) );
+
+    return gar_events_init( &online->events, NULL );
+}
+
+/******************************************************************************/
+bool gar_online_push( gar_online_t* online, gac_t* h, gar_stimuli_t* stimuli,
+        const gar_sample_t* sample, bool has_screen, double arrival )
+{
+    uint32_t fixation_count = online->events.fixation_count;
+    uint32_t saccade_count = online->events.saccade_count;
+    uint32_t analysis_count = online->events.analysis_count;
+
+    if( !gar_batch_parse_samples( h, stimuli, sample, 1, has_screen,
+                &online->events.labels, &online->events ) )
+    {
+        return false;
+    }
+    gar_online_emit( online, fixation_count, saccade_count, analysis_count,
+            arrival );
+
+    return true;
+}
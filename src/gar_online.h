@@ -0,0 +1,233 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef GAR_ONLINE_H
+#define GAR_ONLINE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "gac.h"
+#include "gar_batch.h"
+
+/** The number of bins per power of two of the latency histogram. */
+#define GAR_LATENCY_SUB_BIN_COUNT 8
+/** The number of bins of the latency histogram. The bins cover latencies
+ * from 0 to 2^31 microseconds. */
+#define GAR_LATENCY_BIN_COUNT 240
+
+/** A histogram of event latencies. */
+typedef struct gar_latency_s gar_latency_t;
+/** A push-style parser for live sample streams. */
+typedef struct gar_online_s gar_online_t;
+
+/**
+ * The callback invoked for each detected AOI analysis entry.
+ *
+ * @param data
+ *  The user data registered with the callback.
+ * @param events
+ *  A pointer to the event list holding the entry. It resolves the AOI name
+ *  ID of the entry.
+ * @param analysis
+ *  A pointer to the AOI analysis entry.
+ */
+typedef void ( *gar_online_analysis_cb_t )( void* data, gar_events_t* events,
+        const gar_analysis_item_t* analysis );
+
+/**
+ * The callback invoked for each detected fixation.
+ *
+ * @param data
+ *  The user data registered with the callback.
+ * @param events
+ *  A pointer to the event list holding the fixation. It resolves the label
+ *  ID of the fixation.
+ * @param fixation
+ *  A pointer to the fixation.
+ */
+typedef void ( *gar_online_fixation_cb_t )( void* data, gar_events_t* events,
+        const gar_fixation_item_t* fixation );
+
+/**
+ * The callback invoked for each detected saccade.
+ *
+ * @param data
+ *  The user data registered with the callback.
+ * @param events
+ *  A pointer to the event list holding the saccade. It resolves the label
+ *  ID of the saccade.
+ * @param saccade
+ *  A pointer to the saccade.
+ */
+typedef void ( *gar_online_saccade_cb_t )( void* data, gar_events_t* events,
+        const gar_saccade_item_t* saccade );
+
+/**
+ * A histogram of event latencies. The bins are log-linear: each power of two
+ * of microseconds is split into GAR_LATENCY_SUB_BIN_COUNT bins of equal
+ * width such that the relative bin width is at most 12.5%.
+ */
+struct gar_latency_s
+{
+    /** The number of latencies per bin. */
+    uint64_t bins[GAR_LATENCY_BIN_COUNT];
+    /** The total number of latencies. */
+    uint64_t count;
+    /** The sum of all latencies in seconds. */
+    double sum;
+    /** The largest latency in seconds. */
+    double max;
+};
+
+/**
+ * A push-style parser for live sample streams. Samples are pushed one by
+ * one to a gac handler and each detected event is reported through the
+ * registered callbacks right after the sample which completed the event
+ * was pushed. The time from the arrival of the sample to the emission of
+ * the event is recorded in a latency histogram.
+ */
+struct gar_online_s
+{
+    /** The detected events. The label dictionary resolves the label IDs of
+     * the pushed samples. */
+    gar_events_t events;
+    /** True if the detected events are kept in the event list until
+     * gar_online_clear() is called, false if they are dropped once the
+     * callbacks returned. */
+    bool buffer;
+    /** The optional callback invoked for each fixation. */
+    gar_online_fixation_cb_t on_fixation;
+    /** The optional callback invoked for each saccade. */
+    gar_online_saccade_cb_t on_saccade;
+    /** The optional callback invoked for each AOI analysis entry. */
+    gar_online_analysis_cb_t on_analysis;
+    /** The user data passed to the callbacks. */
+    void* data;
+    /** The latencies from sample arrival to event emission. */
+    gar_latency_t latency;
+};
+
+/**
+ * Record a latency.
+ *
+ * @param latency
+ *  A pointer to the latency histogram.
+ * @param seconds
+ *  The latency in seconds.
+ */
+void gar_latency_add( gar_latency_t* latency, double seconds );
+
+/**
+ * Get the lower bound of a latency histogram bin.
+ *
+ * @param idx
+ *  The index of the bin.
+ * @return
+ *  The lower bound in seconds.
+ */
+double gar_latency_bin_lower( uint32_t idx );
+
+/**
+ * Get the upper bound of a latency histogram bin.
+ *
+ * @param idx
+ *  The index of the bin.
+ * @return
+ *  The upper bound in seconds.
+ */
+double gar_latency_bin_upper( uint32_t idx );
+
+/**
+ * Estimate a quantile of the recorded latencies. The estimate is the upper
+ * bound of the bin holding the quantile, limited to the largest latency.
+ *
+ * @param latency
+ *  A pointer to the latency histogram.
+ * @param q
+ *  The quantile in the range [0, 1].
+ * @return
+ *  The quantile in seconds or NAN if no latency was recorded.
+ */
+double gar_latency_quantile( gar_latency_t* latency, double q );
+
+/**
+ * Remove all latencies from the histogram.
+ *
+ * @param latency
+ *  A pointer to the latency histogram.
+ */
+void gar_latency_reset( gar_latency_t* latency );
+
+/**
+ * Remove all buffered events. The label dictionaries are kept because the
+ * gac handler refers to their strings.
+ *
+ * @param online
+ *  A pointer to the online parser.
+ */
+void gar_online_clear( gar_online_t* online );
+
+/**
+ * Release all memory held by the online parser.
+ *
+ * @param online
+ *  A pointer to the online parser.
+ */
+void gar_online_destroy( gar_online_t* online );
+
+/**
+ * Complete the AOI analysis of the ongoing trial and report the analysis
+ * entries through the callbacks.
+ *
+ * @param online
+ *  A pointer to the online parser.
+ * @param h
+ *  A pointer to the gaze analysis handler the samples were pushed to.
+ * @param stimuli
+ *  A pointer to the AOI sets of the gaze analysis handler or NULL.
+ * @param arrival
+ *  The time of the flush request (see gar_stats_now()).
+ * @return
+ *  True on success, false on failure.
+ */
+bool gar_online_finalise( gar_online_t* online, gac_t* h,
+        gar_stimuli_t* stimuli, double arrival );
+
+/**
+ * Initialise an online parser without callbacks which drops the detected
+ * events.
+ *
+ * @param online
+ *  A pointer to the online parser to initialise.
+ * @return
+ *  True on success, false on failure.
+ */
+bool gar_online_init( gar_online_t* online );
+
+/**
+ * Push one sample to the gac handler and report all events it completes
+ * through the callbacks.
+ *
+ * @param online
+ *  A pointer to the online parser.
+ * @param h
+ *  A pointer to the gaze analysis handler.
+ * @param stimuli
+ *  A pointer to the AOI sets of the gaze analysis handler or NULL.
+ * @param sample
+ *  A pointer to the packed sample. Its label ID must have been interned in
+ *  the label dictionary of the online parser.
+ * @param has_screen
+ *  True if the screen point of the sample is to be used, false otherwise.
+ * @param arrival
+ *  The time the sample arrived (see gar_stats_now()).
+ * @return
+ *  True on success, false on failure.
+ */
+bool gar_online_push( gar_online_t* online, gac_t* h, gar_stimuli_t* stimuli,
+        const gar_sample_t* sample, bool has_screen, double arrival );
+
+#endif
@@ -0,0 +1,655 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include "gar_pipeline.h"
+#include "gar_ring.h"
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+
+/** A block of samples passed between the pipeline stages. */
+typedef struct gar_pipeline_block_s gar_pipeline_block_t;
+/** A detected saccade or fixation passed to the AOI analysis stage. */
+typedef struct gar_pipeline_event_s gar_pipeline_event_t;
+/** The shared state of all stages of one gar_pipeline_parse() call. */
+typedef struct gar_pipeline_s gar_pipeline_t;
+
+/**
+ * A block of samples passed between the pipeline stages. The blocks are
+ * allocated once and circulate from the ingestion stage over the packing
+ * stage to the detection stage and back.
+ */
+struct gar_pipeline_block_s
+{
+    /** The index of the first sample of the block in the recording. */
+    uint32_t offset;
+    /** The number of samples in the block. */
+    uint32_t count;
+    /** The label strings which were added to the label dictionary while
+     * ingesting the block, in the order of their IDs. */
+    const char* labels[GAR_PIPELINE_BLOCK_SIZE];
+    /** The number of new label strings. */
+    uint32_t label_count;
+    /** The label IDs of the samples. */
+    uint32_t label_ids[GAR_PIPELINE_BLOCK_SIZE];
+    /** The packed samples. */
+    gar_sample_t samples[GAR_PIPELINE_BLOCK_SIZE];
+};
+
+/**
+ * A detected saccade or fixation passed to the AOI analysis stage.
+ */
+struct gar_pipeline_event_s
+{
+    /** True if the event is a fixation, false if it is a saccade. */
+    bool is_fixation;
+    /** The event. */
+    union
+    {
+        /** The saccade if `is_fixation` is false. */
+        gac_saccade_t saccade;
+        /** The fixation if `is_fixation` is true. */
+        gac_fixation_t fixation;
+    } event;
+};
+
+/**
+ * The shared state of all stages of one gar_pipeline_parse() call.
+ */
+struct gar_pipeline_s
+{
+    /** The gaze analysis handler. The detection stage owns the sample
+     * window, the AOI analysis stage owns the AOI collection. */
+    gac_t* h;
+    /** The AOI sets of the gaze analysis handler. They are owned by the
+     * stage which runs the AOI analysis. */
+    gar_stimuli_t* stimuli;
+    /** The complete sample columns. */
+    gar_batch_t* samples;
+    /** True if the screen points of the samples are to be used. */
+    bool has_screen;
+    /** True if the AOI analysis is enabled. It is computed before the stages
+     * are started because the AOI collection is swapped by the AOI analysis
+     * stage. */
+    bool has_aoi;
+    /** True if the packing stage runs on its own thread. */
+    bool pack_thread;
+    /** True if the AOI analysis stage runs on its own thread. */
+    bool aoi_thread;
+    /** The sample blocks. */
+    gar_pipeline_block_t* blocks;
+    /** The blocks which are free to be filled by the ingestion stage. */
+    gar_ring_t free;
+    /** The blocks passed from the ingestion to the packing stage. */
+    gar_ring_t ingested;
+    /** The blocks passed from the packing to the detection stage. */
+    gar_ring_t packed;
+    /** The events passed from the detection to the AOI analysis stage. */
+    gar_ring_t detected;
+    /** Set if any stage failed. All stages stop as soon as possible. */
+    bool cancel;
+    /** The label strings known to the detection stage where the index is
+     * the label ID. The strings are owned by the label dictionary of the
+     * samples. */
+    char** names;
+    /** The number of known label strings. */
+    uint32_t name_count;
+    /** The number of allocated label string slots. */
+    uint32_t name_size;
+    /** The events found by the detection stage. */
+    gar_events_t events;
+    /** The AOI analysis entries found by the AOI analysis stage. */
+    gar_events_t analyses;
+};
+
+/**
+ * Hand a detected saccade or fixation over to the AOI analysis stage (see
+ * gar_batch_defer_t).
+ *
+ * @param data
+ *  A pointer to the pipeline.
+ * @param saccade
+ *  A pointer to the detected saccade or NULL.
+ * @param fixation
+ *  A pointer to the detected fixation or NULL.
+ * @return
+ *  True on success, false if the pipeline was cancelled.
+ */
+static bool gar_pipeline_defer( void* data, gac_saccade_t* saccade,
+        gac_fixation_t* fixation );
+
+/**
+ * Destroy all events which are left in the ring to the AOI analysis stage.
+ * This must only be called once all stages have stopped.
+ *
+ * @param pipeline
+ *  A pointer to the pipeline.
+ */
+static void gar_pipeline_drain( gar_pipeline_t* pipeline );
+
+/**
+ * Run the AOI analysis stage. It analyses the detected events in the order
+ * of their detection until the ring from the detection stage is closed.
+ *
+ * @param arg
+ *  A pointer to the pipeline.
+ * @return
+ *  NULL
+ */
+static void* gar_pipeline_aoi_stage( void* arg );
+
+/**
+ * Run the detection stage. It feeds the packed blocks to the sample window
+ * until the ring from the packing stage is closed and returns each block to
+ * the ingestion stage.
+ *
+ * @param arg
+ *  A pointer to the pipeline.
+ * @return
+ *  NULL
+ */
+static void* gar_pipeline_detect_stage( void* arg );
+
+/**
+ * Feed one packed block to the sample window.
+ *
+ * @param pipeline
+ *  A pointer to the pipeline.
+ * @param block
+ *  A pointer to the packed block.
+ * @return
+ *  True on success, false on failure.
+ */
+static bool gar_pipeline_detect( gar_pipeline_t* pipeline,
+        gar_pipeline_block_t* block );
+
+/**
+ * Ingest the samples on the calling thread and pass the blocks on to the
+ * packing stage or, if the packing stage has no thread, pack the blocks and
+ * pass them on to the detection stage.
+ *
+ * @param pipeline
+ *  A pointer to the pipeline.
+ * @param ingest
+ *  The function creating the label IDs of the samples.
+ * @param data
+ *  The data pointer passed to `ingest`.
+ * @return
+ *  True on success, false on failure.
+ */
+static bool gar_pipeline_ingest( gar_pipeline_t* pipeline,
+        gar_pipeline_ingest_t ingest, void* data );
+
+/**
+ * Convert one block to packed sample records.
+ *
+ * @param pipeline
+ *  A pointer to the pipeline.
+ * @param block
+ *  A pointer to the ingested block.
+ */
+static void gar_pipeline_pack( gar_pipeline_t* pipeline,
+        gar_pipeline_block_t* block );
+
+/**
+ * Run the packing stage. It packs the ingested blocks until the ring from
+ * the ingestion stage is closed.
+ *
+ * @param arg
+ *  A pointer to the pipeline.
+ * @return
+ *  NULL
+ */
+static void* gar_pipeline_pack_stage( void* arg );
+
+/**
+ * Parse all samples on the calling thread. This is equal to parsing the
+ * recording block by block with gar_batch_parse().
+ *
+ * @param h
+ *  A pointer to the gaze analysis handler.
+ * @param stimuli
+ *  A pointer to the AOI sets of the gaze analysis handler or NULL.
+ * @param samples
+ *  A pointer to the batch holding the complete sample columns.
+ * @param events
+ *  A pointer to the event list to append the detected events to.
+ * @param ingest
+ *  The function creating the label IDs of the samples.
+ * @param data
+ *  The data pointer passed to `ingest`.
+ * @return
+ *  True on success, false on failure.
+ */
+static bool gar_pipeline_parse_sequential( gac_t* h, gar_stimuli_t* stimuli,
+        gar_batch_t* samples, gar_events_t* events,
+        gar_pipeline_ingest_t ingest, void* data );
+
+/******************************************************************************/
+static void* gar_pipeline_aoi_stage( void* arg )
+{
+    bool res;
+    gar_pipeline_event_t* slot;
+    gar_pipeline_event_t event;
+    gar_pipeline_t* pipeline = arg;
+
+    while( ( slot = gar_ring_front( &pipeline->detected ) ) != NULL )
+    {
+        event = *slot;
+        gar_ring_pop( &pipeline->detected );
+
+        res = true;
+        if( event.is_fixation )
+        {
+            res = gar_batch_analyse_fixation( pipeline->h, pipeline->stimuli,
+                    &event.event.fixation, &pipeline->analyses );
+            gac_fixation_destroy( &event.event.fixation );
+        }
+        else
+        {
+            gar_batch_analyse_saccade( pipeline->h, pipeline->stimuli,
+                    &event.event.saccade, &pipeline->analyses );
+            gac_saccade_destroy( &event.event.saccade );
+        }
+
+        if( !res )
+        {
+            gar_ring_cancel( &pipeline->cancel );
+            break;
+        }
+    }
+
+    return NULL;
+}
+
+/******************************************************************************/
+static bool gar_pipeline_defer( void* data, gac_saccade_t* saccade,
+        gac_fixation_t* fixation )
+{
+    gar_pipeline_t* pipeline = data;
+    gar_pipeline_event_t* slot = gar_ring_reserve( &pipeline->detected );
+
+    if( slot == NULL )
+    {
+        if( fixation != NULL )
+        {
+            gac_fixation_destroy( fixation );
+        }
+        else
+        {
+            gac_saccade_destroy( saccade );
+        }
+        return false;
+    }
+
+    slot->is_fixation = fixation != NULL;
+    if( fixation != NULL )
+    {
+        slot->event.fixation = *fixation;
+    }
+    else
+    {
+        slot->event.saccade = *saccade;
+    }
+    gar_ring_push( &pipeline->detected );
+
+    return true;
+}
+
+/******************************************************************************/
+static bool gar_pipeline_detect( gar_pipeline_t* pipeline,
+        gar_pipeline_block_t* block )
+{
+    uint32_t i, size;
+    char** names;
+    gar_labels_t view;
+
+    if( pipeline->name_count + block->label_count > pipeline->name_size )
+    {
+        size = pipeline->name_size;
+        while( pipeline->name_count + block->label_count > size )
+        {
+            size *= 2;
+        }
+        names = realloc( pipeline->names, size * sizeof( char* ) );
+        if( names == NULL )
+        {
+            return false;
+        }
+        pipeline->names = names;
+        pipeline->name_size = size;
+    }
+    for( i = 0; i < block->label_count; i++ )
+    {
+        pipeline->names[pipeline->name_count++] = ( char* )block->labels[i];
+    }
+
+    // a read-only view which only resolves label IDs, it is never modified
+    memset( &view, 0, sizeof( gar_labels_t ) );
+    view.items = pipeline->names;
+    view.count = pipeline->name_count;
+
+    return gar_batch_parse_deferred( pipeline->h, pipeline->stimuli,
+            block->samples, block->count, pipeline->has_screen,
+            pipeline->has_aoi, &view, &pipeline->events,
+            pipeline->aoi_thread ? gar_pipeline_defer : NULL, pipeline );
+}
+
+/******************************************************************************/
+static void* gar_pipeline_detect_stage( void* arg )
+{
+    gar_pipeline_block_t** slot;
+    gar_pipeline_block_t* block;
+    gar_pipeline_t* pipeline = arg;
+
+    while( ( slot = gar_ring_front( &pipeline->packed ) ) != NULL )
+    {
+        block = *slot;
+        gar_ring_pop( &pipeline->packed );
+
+        if( !gar_pipeline_detect( pipeline, block ) )
+        {
+            gar_ring_cancel( &pipeline->cancel );
+            break;
+        }
+
+        // the free ring holds all blocks, a slot is always available
+        slot = gar_ring_reserve( &pipeline->free );
+        *slot = block;
+        gar_ring_push( &pipeline->free );
+    }
+
+    gar_ring_close( &pipeline->detected );
+
+    return NULL;
+}
+
+/******************************************************************************/
+static void gar_pipeline_drain( gar_pipeline_t* pipeline )
+{
+    gar_pipeline_event_t* slot;
+
+    // all stages have stopped, read the remaining events despite the cancel
+    pipeline->detected.cancel = NULL;
+    gar_ring_close( &pipeline->detected );
+    while( ( slot = gar_ring_front( &pipeline->detected ) ) != NULL )
+    {
+        if( slot->is_fixation )
+        {
+            gac_fixation_destroy( &slot->event.fixation );
+        }
+        else
+        {
+            gac_saccade_destroy( &slot->event.saccade );
+        }
+        gar_ring_pop( &pipeline->detected );
+    }
+}
+
+/******************************************************************************/
+static bool gar_pipeline_ingest( gar_pipeline_t* pipeline,
+        gar_pipeline_ingest_t ingest, void* data )
+{
+    uint32_t i, k, label_count;
+    gar_pipeline_block_t** slot;
+    gar_pipeline_block_t* block;
+    gar_labels_t* labels = pipeline->samples->labels;
+    bool res = true;
+
+    for( i = 0; i < pipeline->samples->count; i += block->count )
+    {
+        slot = gar_ring_front( &pipeline->free );
+        if( slot == NULL )
+        {
+            // a later stage failed
+            break;
+        }
+        block = *slot;
+        gar_ring_pop( &pipeline->free );
+
+        block->offset = i;
+        block->count = pipeline->samples->count - i;
+        if( block->count > GAR_PIPELINE_BLOCK_SIZE )
+        {
+            block->count = GAR_PIPELINE_BLOCK_SIZE;
+        }
+
+        // each sample adds at most one label
+        label_count = labels->count;
+        res = ingest( data, i, block->count, block->label_ids, labels );
+        if( !res )
+        {
+            gar_ring_cancel( &pipeline->cancel );
+            break;
+        }
+        block->label_count = 0;
+        for( k = label_count; k < labels->count; k++ )
+        {
+            block->labels[block->label_count++] = labels->items[k];
+        }
+
+        if( !pipeline->pack_thread )
+        {
+            gar_pipeline_pack( pipeline, block );
+        }
+        slot = gar_ring_reserve( pipeline->pack_thread ? &pipeline->ingested
+                : &pipeline->packed );
+        if( slot == NULL )
+        {
+            break;
+        }
+        *slot = block;
+        gar_ring_push( pipeline->pack_thread ? &pipeline->ingested
+                : &pipeline->packed );
+    }
+
+    gar_ring_close( pipeline->pack_thread ? &pipeline->ingested
+            : &pipeline->packed );
+
+    return res;
+}
+
+/******************************************************************************/
+static void gar_pipeline_pack( gar_pipeline_t* pipeline,
+        gar_pipeline_block_t* block )
+{
+    gar_batch_t batch;
+
+    gar_batch_slice( &batch, pipeline->samples, block->offset, block->count );
+    batch.label = block->label_ids;
+    gar_batch_pack( &batch, block->samples );
+}
+
+/******************************************************************************/
+static void* gar_pipeline_pack_stage( void* arg )
+{
+    gar_pipeline_block_t** slot;
+    gar_pipeline_block_t* block;
+    gar_pipeline_t* pipeline = arg;
+
+    while( ( slot = gar_ring_front( &pipeline->ingested ) ) != NULL )
+    {
+        block = *slot;
+        gar_ring_pop( &pipeline->ingested );
+
+        gar_pipeline_pack( pipeline, block );
+
+        slot = gar_ring_reserve( &pipeline->packed );
+        if( slot == NULL )
+        {
+            break;
+        }
+        *slot = block;
+        gar_ring_push( &pipeline->packed );
+    }
+
+    gar_ring_close( &pipeline->packed );
+
+    return NULL;
+}
+
+/******************************************************************************/
+bool gar_pipeline_parse( gac_t* h, gar_stimuli_t* stimuli,
+        gar_batch_t* samples, gar_events_t* events, uint32_t stage_count,
+        gar_pipeline_ingest_t ingest, void* data )
+{
+    uint32_t i, started, extra;
+    bool res;
+    pthread_t threads[GAR_PIPELINE_STAGE_COUNT - 1];
+    void* ( *stages[GAR_PIPELINE_STAGE_COUNT - 1] )( void* );
+    gar_pipeline_block_t** slot;
+    gar_pipeline_t pipeline;
+    gar_labels_t* labels = samples->labels;
+
+    if( stage_count <= 1 || samples->count <= GAR_PIPELINE_BLOCK_SIZE )
+    {
+        return gar_pipeline_parse_sequential( h, stimuli, samples, events,
+                ingest, data );
+    }
+
+    memset( &pipeline, 0, sizeof( gar_pipeline_t ) );
+    pipeline.h = h;
+    pipeline.stimuli = stimuli;
+    pipeline.samples = samples;
+    pipeline.has_screen = ( samples->sx != NULL && samples->sy != NULL )
+        || samples->screen != NULL;
+    pipeline.has_aoi = gar_stimuli_has_aoi( stimuli, h );
+
+    // the detection stage gets the first extra thread, the AOI analysis
+    // stage the second one if there are AOIs, and the packing stage the rest
+    extra = ( stage_count < GAR_PIPELINE_STAGE_COUNT ? stage_count
+            : GAR_PIPELINE_STAGE_COUNT ) - 1;
+    extra--;
+    if( extra > 0 && pipeline.has_aoi )
+    {
+        pipeline.aoi_thread = true;
+        extra--;
+    }
+    pipeline.pack_thread = extra > 0;
+
+    pipeline.blocks = malloc( GAR_PIPELINE_BLOCK_COUNT
+            * sizeof( gar_pipeline_block_t ) );
+    pipeline.name_size = labels->count > 16 ? labels->count : 16;
+    pipeline.names = malloc( pipeline.name_size * sizeof( char* ) );
+    res = pipeline.blocks != NULL && pipeline.names != NULL
+        && gar_ring_init( &pipeline.free, GAR_PIPELINE_BLOCK_COUNT,
+                sizeof( gar_pipeline_block_t* ), &pipeline.cancel )
+        && gar_ring_init( &pipeline.ingested, GAR_PIPELINE_BLOCK_COUNT,
+                sizeof( gar_pipeline_block_t* ), &pipeline.cancel )
+        && gar_ring_init( &pipeline.packed, GAR_PIPELINE_BLOCK_COUNT,
+                sizeof( gar_pipeline_block_t* ), &pipeline.cancel )
+        && gar_ring_init( &pipeline.detected, GAR_PIPELINE_EVENT_COUNT,
+                sizeof( gar_pipeline_event_t ), &pipeline.cancel )
+        && gar_events_init( &pipeline.events, NULL )
+        && gar_events_init( &pipeline.analyses, NULL );
+
+    started = 0;
+    if( res )
+    {
+        // the labels interned before the call are known to all stages
+        for( i = 0; i < labels->count; i++ )
+        {
+            pipeline.names[i] = labels->items[i];
+        }
+        pipeline.name_count = labels->count;
+
+        for( i = 0; i < GAR_PIPELINE_BLOCK_COUNT; i++ )
+        {
+            slot = gar_ring_reserve( &pipeline.free );
+            *slot = &pipeline.blocks[i];
+            gar_ring_push( &pipeline.free );
+        }
+
+        extra = 0;
+        stages[extra++] = gar_pipeline_detect_stage;
+        if( pipeline.aoi_thread )
+        {
+            stages[extra++] = gar_pipeline_aoi_stage;
+        }
+        if( pipeline.pack_thread )
+        {
+            stages[extra++] = gar_pipeline_pack_stage;
+        }
+        for( i = 0; i < extra; i++ )
+        {
+            if( pthread_create( &threads[i], NULL, stages[i], &pipeline )
+                    != 0 )
+            {
+                break;
+            }
+            started++;
+        }
+
+        if( started == extra )
+        {
+            res = gar_pipeline_ingest( &pipeline, ingest, data );
+        }
+        else
+        {
+            // not all stages could be started, stop the started ones
+            gar_ring_cancel( &pipeline.cancel );
+            gar_ring_close( &pipeline.ingested );
+            gar_ring_close( &pipeline.packed );
+        }
+    }
+
+    for( i = 0; i < started; i++ )
+    {
+        pthread_join( threads[i], NULL );
+    }
+
+    if( res && started < extra )
+    {
+        // no sample was parsed yet, fall back to the calling thread
+        res = gar_pipeline_parse_sequential( h, stimuli, samples, events,
+                ingest, data );
+    }
+    else if( res )
+    {
+        res = !pipeline.cancel
+            && gar_events_append( events, &pipeline.events )
+            && gar_events_append( events, &pipeline.analyses );
+    }
+
+    if( pipeline.detected.items != NULL )
+    {
+        gar_pipeline_drain( &pipeline );
+    }
+    gar_events_destroy( &pipeline.events );
+    gar_events_destroy( &pipeline.analyses );
+    gar_ring_destroy( &pipeline.free );
+    gar_ring_destroy( &pipeline.ingested );
+    gar_ring_destroy( &pipeline.packed );
+    gar_ring_destroy( &pipeline.detected );
+    free( pipeline.names );
+    free( pipeline.blocks );
+
+    return res;
+}
+
+/******************************************************************************/
+static bool gar_pipeline_parse_sequential( gac_t* h, gar_stimuli_t* stimuli,
+        gar_batch_t* samples, gar_events_t* events,
+        gar_pipeline_ingest_t ingest, void* data )
+{
+    uint32_t label_ids[GAR_BATCH_SIZE];
+    uint32_t i;
+    bool res = true;
+    gar_batch_t batch;
+
+    for( i = 0; res && i < samples->count; i += batch.count )
+    {
+        gar_batch_slice( &batch, samples, i, GAR_BATCH_SIZE );
+        batch.label = label_ids;
+        res = ingest( data, i, batch.count, label_ids, samples->labels );
+        if( res )
+        {
+            res = gar_batch_parse( h, stimuli, &batch, events );
+        }
+    }
+
+    return res;
+}
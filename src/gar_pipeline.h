@@ -0,0 +1,88 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef GAR_PIPELINE_H
+#define GAR_PIPELINE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "gac.h"
+#include "gar_batch.h"
+#include "gar_labels.h"
+
+/** The maximal number of pipeline stages which run on their own thread. */
+#define GAR_PIPELINE_STAGE_COUNT 4
+/** The number of samples passed between the stages at once. */
+#define GAR_PIPELINE_BLOCK_SIZE 1024
+/** The number of sample blocks in flight between the stages. */
+#define GAR_PIPELINE_BLOCK_COUNT 8
+/** The number of detected events in flight to the AOI analysis stage. */
+#define GAR_PIPELINE_EVENT_COUNT 256
+
+/**
+ * Intern the labels of a range of samples. This is the ingestion stage of
+ * the pipeline and always runs on the calling thread such that it may use
+ * the R API.
+ *
+ * @param data
+ *  The data pointer passed to gar_pipeline_parse().
+ * @param offset
+ *  The index of the first sample of the range.
+ * @param count
+ *  The number of samples of the range.
+ * @param ids
+ *  The destination of the label IDs of the range.
+ * @param labels
+ *  The label dictionary to intern the labels into.
+ * @return
+ *  True on success, false on failure.
+ */
+typedef bool ( *gar_pipeline_ingest_t )( void* data, uint32_t offset,
+        uint32_t count, uint32_t* ids, gar_labels_t* labels );
+
+/**
+ * Parse a recording with the per-sample work split into stages which are
+ * connected by lock-free single-producer single-consumer rings:
+ *
+ *  1. ingestion: label interning (always on the calling thread),
+ *  2. packing: conversion to packed sample records and screen projection,
+ *  3. detection: sample window update (gap and noise filter), saccade
+ *     filter, and fixation filter,
+ *  4. AOI analysis of the detected saccades and fixations.
+ *
+ * The gap filter, the noise filter, and the event filters share the sample
+ * window of the gac handler and therefore form a single stage. Additional
+ * threads are assigned to the detection stage first, then to the AOI
+ * analysis stage (only if the handler has AOIs), and then to the packing
+ * stage. Stages without a thread run on the thread of the preceding stage.
+ * The detected events are equal to the ones of the sequential path which
+ * is used if `stage_count` is 1 or if no thread could be started.
+ *
+ * @param h
+ *  A pointer to the gaze analysis handler.
+ * @param stimuli
+ *  A pointer to the AOI sets of the gaze analysis handler or NULL.
+ * @param samples
+ *  A pointer to the batch holding the complete sample columns. The label IDs
+ *  are created by `ingest` and are resolved by the label dictionary of the
+ *  batch.
+ * @param events
+ *  A pointer to the event list to append the detected events to.
+ * @param stage_count
+ *  The number of threads to use, including the calling thread. It is
+ *  limited to GAR_PIPELINE_STAGE_COUNT.
+ * @param ingest
+ *  The function creating the label IDs of the samples.
+ * @param data
+ *  The data pointer passed to `ingest`.
+ * @return
+ *  True on success, false on failure.
+ */
+bool gar_pipeline_parse( gac_t* h, gar_stimuli_t* stimuli,
+        gar_batch_t* samples, gar_events_t* events, uint32_t stage_count,
+        gar_pipeline_ingest_t ingest, void* data );
+
+#endif
@@ -0,0 +1,160 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include "gar_ring.h"
+#include <sched.h>
+#include <stdlib.h>
+#include <string.h>
+
+/** The number of polls before a waiting thread starts to yield. */
+#define GAR_RING_SPIN_COUNT 128
+
+/**
+ * Check whether the pipeline of a ring was cancelled.
+ *
+ * @param ring
+ *  A pointer to the ring.
+ * @return
+ *  True if the pipeline was cancelled, false otherwise.
+ */
+static bool gar_ring_is_cancelled( gar_ring_t* ring );
+
+/**
+ * Wait for the other side of a ring. The first polls spin, later polls yield
+ * the processor such that the other side makes progress on an oversubscribed
+ * machine.
+ *
+ * @param spins
+ *  A pointer to the number of polls so far. This is updated from within the
+ *  function.
+ */
+static void gar_ring_wait( uint32_t* spins );
+
+/******************************************************************************/
+void gar_ring_cancel( bool* cancel )
+{
+    __atomic_store_n( cancel, true, __ATOMIC_RELEASE );
+}
+
+/******************************************************************************/
+void gar_ring_close( gar_ring_t* ring )
+{
+    __atomic_store_n( &ring->closed, true, __ATOMIC_RELEASE );
+}
+
+/******************************************************************************/
+void gar_ring_destroy( gar_ring_t* ring )
+{
+    free( ring->items );
+    ring->items = NULL;
+}
+
+/******************************************************************************/
+void* gar_ring_front( gar_ring_t* ring )
+{
+    uint32_t spins = 0;
+    uint32_t head = __atomic_load_n( &ring->head, __ATOMIC_RELAXED );
+
+    while( true )
+    {
+        if( __atomic_load_n( &ring->tail, __ATOMIC_ACQUIRE ) != head )
+        {
+            return ring->items + ( head & ring->mask ) * ring->item_size;
+        }
+        if( __atomic_load_n( &ring->closed, __ATOMIC_ACQUIRE ) )
+        {
+            // items pushed right before closing are still to be read
+            if( __atomic_load_n( &ring->tail, __ATOMIC_ACQUIRE ) == head )
+            {
+                return NULL;
+            }
+            continue;
+        }
+        if( gar_ring_is_cancelled( ring ) )
+        {
+            return NULL;
+        }
+        gar_ring_wait( &spins );
+    }
+}
+
+/******************************************************************************/
+bool gar_ring_init( gar_ring_t* ring, uint32_t capacity, size_t item_size,
+        const bool* cancel )
+{
+    uint32_t size = 1;
+
+    while( size < capacity )
+    {
+        size <<= 1;
+    }
+
+    memset( ring, 0, sizeof( gar_ring_t ) );
+    ring->items = malloc( size * item_size );
+    if( ring->items == NULL )
+    {
+        return false;
+    }
+    ring->item_size = item_size;
+    ring->mask = size - 1;
+    ring->cancel = cancel;
+
+    return true;
+}
+
+/******************************************************************************/
+static bool gar_ring_is_cancelled( gar_ring_t* ring )
+{
+    return ring->cancel != NULL
+        && __atomic_load_n( ring->cancel, __ATOMIC_ACQUIRE );
+}
+
+/******************************************************************************/
+void gar_ring_pop( gar_ring_t* ring )
+{
+    uint32_t head = __atomic_load_n( &ring->head, __ATOMIC_RELAXED );
+
+    __atomic_store_n( &ring->head, head + 1, __ATOMIC_RELEASE );
+}
+
+/******************************************************************************/
+void gar_ring_push( gar_ring_t* ring )
+{
+    uint32_t tail = __atomic_load_n( &ring->tail, __ATOMIC_RELAXED );
+
+    __atomic_store_n( &ring->tail, tail + 1, __ATOMIC_RELEASE );
+}
+
+/******************************************************************************/
+void* gar_ring_reserve( gar_ring_t* ring )
+{
+    uint32_t spins = 0;
+    uint32_t tail = __atomic_load_n( &ring->tail, __ATOMIC_RELAXED );
+
+    while( tail - __atomic_load_n( &ring->head, __ATOMIC_ACQUIRE )
+            > ring->mask )
+    {
+        if( gar_ring_is_cancelled( ring ) )
+        {
+            return NULL;
+        }
+        gar_ring_wait( &spins );
+    }
+
+    return ring->items + ( tail & ring->mask ) * ring->item_size;
+}
+
+/******************************************************************************/
+static void gar_ring_wait( uint32_t* spins )
+{
+    if( *spins < GAR_RING_SPIN_COUNT )
+    {
+        ( *spins )++;
+        return;
+    }
+
+    sched_yield();
+}
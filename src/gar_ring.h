@@ -0,0 +1,137 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef GAR_RING_H
+#define GAR_RING_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/** The size of a cache line in bytes the ring indices are separated by. */
+#define GAR_RING_CACHE_LINE 64
+
+/** A lock-free single-producer single-consumer ring buffer. */
+typedef struct gar_ring_s gar_ring_t;
+
+/**
+ * A lock-free ring buffer of fixed size items which connects exactly one
+ * producer thread with exactly one consumer thread. The producer fills the
+ * slot returned by gar_ring_reserve() and publishes it with gar_ring_push().
+ * The consumer reads the slot returned by gar_ring_front() and hands it back
+ * with gar_ring_pop(). The indices are only written by their owner and are
+ * kept on separate cache lines such that the two threads do not contend.
+ * A thread waiting for a slot spins shortly and then yields the processor.
+ */
+struct gar_ring_s
+{
+    /** The index of the next slot to read. Written by the consumer. */
+    uint32_t head;
+    char head_pad[GAR_RING_CACHE_LINE - sizeof( uint32_t )];
+    /** The index of the next slot to write. Written by the producer. */
+    uint32_t tail;
+    char tail_pad[GAR_RING_CACHE_LINE - sizeof( uint32_t )];
+    /** True once the producer will not push any more items. */
+    bool closed;
+    /** An optional flag shared by all rings of a pipeline. If set, all
+     * waiting threads give up (may be NULL). */
+    const bool* cancel;
+    /** The item storage. */
+    char* items;
+    /** The size of one item in bytes. */
+    size_t item_size;
+    /** The number of slots minus one. The number of slots is a power of
+     * two. */
+    uint32_t mask;
+};
+
+/**
+ * Set a cancel flag such that all threads waiting on rings which share the
+ * flag give up.
+ *
+ * @param cancel
+ *  A pointer to the shared cancel flag.
+ */
+void gar_ring_cancel( bool* cancel );
+
+/**
+ * Mark the end of the stream. The consumer receives NULL from
+ * gar_ring_front() once all pushed items were read. This must only be called
+ * by the producer.
+ *
+ * @param ring
+ *  A pointer to the ring.
+ */
+void gar_ring_close( gar_ring_t* ring );
+
+/**
+ * Release all memory held by the ring.
+ *
+ * @param ring
+ *  A pointer to the ring.
+ */
+void gar_ring_destroy( gar_ring_t* ring );
+
+/**
+ * Get the oldest item of the ring without removing it. The call blocks until
+ * an item is available. This must only be called by the consumer.
+ *
+ * @param ring
+ *  A pointer to the ring.
+ * @return
+ *  A pointer to the item or NULL if the ring is closed and empty or if the
+ *  pipeline was cancelled.
+ */
+void* gar_ring_front( gar_ring_t* ring );
+
+/**
+ * Initialise an empty ring.
+ *
+ * @param ring
+ *  A pointer to the ring to initialise.
+ * @param capacity
+ *  The minimal number of slots. It is rounded up to a power of two.
+ * @param item_size
+ *  The size of one item in bytes.
+ * @param cancel
+ *  An optional cancel flag shared by all rings of a pipeline (may be NULL).
+ * @return
+ *  True on success, false on failure.
+ */
+bool gar_ring_init( gar_ring_t* ring, uint32_t capacity, size_t item_size,
+        const bool* cancel );
+
+/**
+ * Remove the item returned by the last gar_ring_front() call from the ring
+ * and hand its slot back to the producer. This must only be called by the
+ * consumer.
+ *
+ * @param ring
+ *  A pointer to the ring.
+ */
+void gar_ring_pop( gar_ring_t* ring );
+
+/**
+ * Publish the slot returned by the last gar_ring_reserve() call to the
+ * consumer. This must only be called by the producer.
+ *
+ * @param ring
+ *  A pointer to the ring.
+ */
+void gar_ring_push( gar_ring_t* ring );
+
+/**
+ * Get the next free slot of the ring. The call blocks until a slot is free.
+ * This must only be called by the producer.
+ *
+ * @param ring
+ *  A pointer to the ring.
+ * @return
+ *  A pointer to the slot or NULL if the pipeline was cancelled.
+ */
+void* gar_ring_reserve( gar_ring_t* ring );
+
+#endif
@@ -0,0 +1,214 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include "gar_screen.h"
+#include <math.h>
+#include <string.h>
+
+/** The number of samples projected at once. */
+#define GAR_SCREEN_LANES 4
+
+/**
+ * Four single precision values which are processed with one vector
+ * instruction if the target supports it. The compiler splits the operations
+ * into scalar instructions otherwise.
+ */
+typedef float gar_screen_v4_t __attribute__(( vector_size( 16 ) ));
+
+/**
+ * Compute the cross product of two vectors.
+ *
+ * @param a
+ *  The first vector.
+ * @param b
+ *  The second vector.
+ * @param res
+ *  The destination of the cross product.
+ */
+static void gar_screen_cross( const double* a, const double* b, double* res );
+
+/**
+ * Compute the dot product of two vectors.
+ *
+ * @param a
+ *  The first vector.
+ * @param b
+ *  The second vector.
+ * @return
+ *  The dot product.
+ */
+static double gar_screen_dot( const double* a, const double* b );
+
+/**
+ * Project one gaze sample onto the screen (see gar_screen_project()).
+ *
+ * @param screen
+ *  A pointer to the screen basis.
+ * @param px
+ *  The x coordinates of the gaze points.
+ * @param py
+ *  The y coordinates of the gaze points.
+ * @param pz
+ *  The z coordinates of the gaze points.
+ * @param ox
+ *  The x coordinates of the gaze origins.
+ * @param oy
+ *  The y coordinates of the gaze origins.
+ * @param oz
+ *  The z coordinates of the gaze origins.
+ * @param sx
+ *  The destination of the normalised x coordinates.
+ * @param sy
+ *  The destination of the normalised y coordinates.
+ * @param i
+ *  The index of the sample to project.
+ */
+static inline void gar_screen_project_sample( const gar_screen_t* screen,
+        const float* restrict px, const float* restrict py,
+        const float* restrict pz, const float* restrict ox,
+        const float* restrict oy, const float* restrict oz,
+        float* restrict sx, float* restrict sy, uint32_t i );
+
+/******************************************************************************/
+static void gar_screen_cross( const double* a, const double* b, double* res )
+{
+    res[0] = a[1] * b[2] - a[2] * b[1];
+    res[1] = a[2] * b[0] - a[0] * b[2];
+    res[2] = a[0] * b[1] - a[1] * b[0];
+}
+
+/******************************************************************************/
+static double gar_screen_dot( const double* a, const double* b )
+{
+    return a[0] * b[0] + a[1] * b[1] + a[2] * b[2];
+}
+
+/******************************************************************************/
+bool gar_screen_init( gar_screen_t* screen, const double* corners )
+{
+    uint32_t i;
+    double e_x[3], e_y[3], normal[3], tmp[3];
+    double norm_x, norm_y;
+
+    for( i = 0; i < 3; i++ )
+    {
+        screen->origin[i] = corners[i];
+        e_x[i] = corners[3 + i] - corners[i];
+        e_y[i] = corners[6 + i] - corners[i];
+    }
+    gar_screen_cross( e_x, e_y, normal );
+
+    // the dual vectors are perpendicular to the other edge and to the normal
+    gar_screen_cross( e_y, normal, tmp );
+    norm_x = gar_screen_dot( e_x, tmp );
+    for( i = 0; i < 3; i++ )
+    {
+        screen->dual_x[i] = tmp[i] / norm_x;
+    }
+    gar_screen_cross( normal, e_x, tmp );
+    norm_y = gar_screen_dot( e_y, tmp );
+    for( i = 0; i < 3; i++ )
+    {
+        screen->normal[i] = normal[i];
+        screen->dual_y[i] = tmp[i] / norm_y;
+    }
+
+    return norm_x != 0 && norm_y != 0 && isfinite( norm_x )
+        && isfinite( norm_y );
+}
+
+/******************************************************************************/
+void gar_screen_project( const gar_screen_t* screen,
+        const float* restrict px, const float* restrict py,
+        const float* restrict pz, const float* restrict ox,
+        const float* restrict oy, const float* restrict oz,
+        float* restrict sx, float* restrict sy, uint32_t count )
+{
+    uint32_t i = 0;
+    gar_screen_v4_t x, y, z, dx, dy, dz, rx, ry, rz, t;
+    const float* n = screen->normal;
+    const float* c = screen->origin;
+    const float* u = screen->dual_x;
+    const float* v = screen->dual_y;
+    const gar_screen_v4_t n0 = { n[0], n[0], n[0], n[0] };
+    const gar_screen_v4_t n1 = { n[1], n[1], n[1], n[1] };
+    const gar_screen_v4_t n2 = { n[2], n[2], n[2], n[2] };
+    const gar_screen_v4_t c0 = { c[0], c[0], c[0], c[0] };
+    const gar_screen_v4_t c1 = { c[1], c[1], c[1], c[1] };
+    const gar_screen_v4_t c2 = { c[2], c[2], c[2], c[2] };
+    const gar_screen_v4_t u0 = { u[0], u[0], u[0], u[0] };
+    const gar_screen_v4_t u1 = { u[1], u[1], u[1], u[1] };
+    const gar_screen_v4_t u2 = { u[2], u[2], u[2], u[2] };
+    const gar_screen_v4_t v0 = { v[0], v[0], v[0], v[0] };
+    const gar_screen_v4_t v1 = { v[1], v[1], v[1], v[1] };
+    const gar_screen_v4_t v2 = { v[2], v[2], v[2], v[2] };
+
+    for( ; i + GAR_SCREEN_LANES <= count; i += GAR_SCREEN_LANES )
+    {
+        // gaze origin relative to the top left corner
+        memcpy( &x, &ox[i], sizeof( gar_screen_v4_t ) );
+        memcpy( &y, &oy[i], sizeof( gar_screen_v4_t ) );
+        memcpy( &z, &oz[i], sizeof( gar_screen_v4_t ) );
+        rx = x - c0;
+        ry = y - c1;
+        rz = z - c2;
+
+        // gaze direction
+        memcpy( &dx, &px[i], sizeof( gar_screen_v4_t ) );
+        memcpy( &dy, &py[i], sizeof( gar_screen_v4_t ) );
+        memcpy( &dz, &pz[i], sizeof( gar_screen_v4_t ) );
+        dx -= x;
+        dy -= y;
+        dz -= z;
+
+        // ray parameter of the intersection with the screen plane
+        t = -( n0 * rx + n1 * ry + n2 * rz ) / ( n0 * dx + n1 * dy + n2 * dz );
+
+        rx += t * dx;
+        ry += t * dy;
+        rz += t * dz;
+        x = u0 * rx + u1 * ry + u2 * rz;
+        y = v0 * rx + v1 * ry + v2 * rz;
+        memcpy( &sx[i], &x, sizeof( gar_screen_v4_t ) );
+        memcpy( &sy[i], &y, sizeof( gar_screen_v4_t ) );
+    }
+    for( ; i < count; i++ )
+    {
+        gar_screen_project_sample( screen, px, py, pz, ox, oy, oz, sx, sy, i );
+    }
+}
+
+/******************************************************************************/
+static inline void gar_screen_project_sample( const gar_screen_t* screen,
+        const float* restrict px, const float* restrict py,
+        const float* restrict pz, const float* restrict ox,
+        const float* restrict oy, const float* restrict oz,
+        float* restrict sx, float* restrict sy, uint32_t i )
+{
+    float dx, dy, dz, rx, ry, rz, t;
+    const float* n = screen->normal;
+    const float* c = screen->origin;
+    const float* u = screen->dual_x;
+    const float* v = screen->dual_y;
+
+    // gaze direction and gaze origin relative to the top left corner
+    dx = px[i] - ox[i];
+    dy = py[i] - oy[i];
+    dz = pz[i] - oz[i];
+    rx = ox[i] - c[0];
+    ry = oy[i] - c[1];
+    rz = oz[i] - c[2];
+
+    // ray parameter of the intersection with the screen plane
+    t = -( n[0] * rx + n[1] * ry + n[2] * rz )
+        / ( n[0] * dx + n[1] * dy + n[2] * dz );
+
+    rx += t * dx;
+    ry += t * dy;
+    rz += t * dz;
+    sx[i] = u[0] * rx + u[1] * ry + u[2] * rz;
+    sy[i] = v[0] * rx + v[1] * ry + v[2] * rz;
+}
@@ -0,0 +1,86 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef GAR_SCREEN_H
+#define GAR_SCREEN_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/** The precomputed basis of a screen plane. */
+typedef struct gar_screen_s gar_screen_t;
+
+/**
+ * The precomputed basis of a screen plane. The screen is spanned by the
+ * edges from the top left to the top right corner (x axis) and from the top
+ * left to the bottom left corner (y axis). The dual vectors of the edges map
+ * a point on the plane to its normalised screen coordinates with two dot
+ * products. The basis is computed in double precision and stored in single
+ * precision, the precision of the gac filters.
+ */
+struct gar_screen_s
+{
+    /** The top left corner of the screen. */
+    float origin[3];
+    /** The normal of the screen plane (not normalised). */
+    float normal[3];
+    /** The dual vector of the x axis. */
+    float dual_x[3];
+    /** The dual vector of the y axis. */
+    float dual_y[3];
+};
+
+/**
+ * Compute the basis of a screen plane.
+ *
+ * @param screen
+ *  A pointer to the screen basis to initialise.
+ * @param corners
+ *  The screen position: top left, top right, and bottom left corner, each
+ *  as x, y, and z coordinate.
+ * @return
+ *  True on success, false if the corners do not span a plane.
+ */
+bool gar_screen_init( gar_screen_t* screen, const double* corners );
+
+/**
+ * Project a block of gaze samples onto the screen. Each gaze ray from the
+ * gaze origin through the gaze point is intersected with the screen plane
+ * and the intersection is converted to normalised screen coordinates where
+ * the top left corner is (0, 0) and the bottom right corner is (1, 1). Rays
+ * which are parallel to the screen yield NaN or infinite coordinates. Four
+ * samples are projected at once with vector instructions (SSE, NEON, ...).
+ *
+ * This function does not use the R API and may be called from any thread.
+ *
+ * @param screen
+ *  A pointer to the screen basis.
+ * @param px
+ *  The x coordinates of the gaze points.
+ * @param py
+ *  The y coordinates of the gaze points.
+ * @param pz
+ *  The z coordinates of the gaze points.
+ * @param ox
+ *  The x coordinates of the gaze origins.
+ * @param oy
+ *  The y coordinates of the gaze origins.
+ * @param oz
+ *  The z coordinates of the gaze origins.
+ * @param sx
+ *  The destination of the normalised x coordinates.
+ * @param sy
+ *  The destination of the normalised y coordinates.
+ * @param count
+ *  The number of samples to project.
+ */
+void gar_screen_project( const gar_screen_t* screen,
+        const float* restrict px, const float* restrict py,
+        const float* restrict pz, const float* restrict ox,
+        const float* restrict oy, const float* restrict oz,
+        float* restrict sx, float* restrict sy, uint32_t count );
+
+#endif
@@ -0,0 +1,116 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include "gar_stats.h"
+#include <stddef.h>
+#include <time.h>
+
+#ifdef GAR_STATS
+/** The number of heap allocations of the current thread. */
+static __thread uint64_t gar_stats_alloc_count = 0;
+
+/** The libc implementation of calloc (resolved by the linker). */
+void* __real_calloc( size_t count, size_t size );
+
+/** The libc implementation of malloc (resolved by the linker). */
+void* __real_malloc( size_t size );
+
+/** The libc implementation of realloc (resolved by the linker). */
+void* __real_realloc( void* ptr, size_t size );
+
+/**
+ * Count a call to calloc and forward it to libc.
+ *
+ * @param count
+ *  The number of elements to allocate.
+ * @param size
+ *  The size of one element in bytes.
+ * @return
+ *  A pointer to the allocated memory or NULL on failure.
+ */
+void* __wrap_calloc( size_t count, size_t size );
+
+/**
+ * Count a call to malloc and forward it to libc.
+ *
+ * @param size
+ *  The number of bytes to allocate.
+ * @return
+ *  A pointer to the allocated memory or NULL on failure.
+ */
+void* __wrap_malloc( size_t size );
+
+/**
+ * Count a call to realloc and forward it to libc.
+ *
+ * @param ptr
+ *  A pointer to the memory to resize.
+ * @param size
+ *  The new size in bytes.
+ * @return
+ *  A pointer to the reallocated memory or NULL on failure.
+ */
+void* __wrap_realloc( void* ptr, size_t size );
+#endif
+
+/******************************************************************************/
+void gar_stats_add( gar_stats_t* dst, gar_stats_t* src )
+{
+    dst->samples_in += src->samples_in;
+    dst->samples_added += src->samples_added;
+    dst->fixations += src->fixations;
+    dst->saccades += src->saccades;
+    dst->analyses += src->analyses;
+    dst->aoi_tests += src->aoi_tests;
+    dst->allocs += src->allocs;
+    dst->time_update += src->time_update;
+    dst->time_saccade += src->time_saccade;
+    dst->time_fixation += src->time_fixation;
+    dst->time_aoi += src->time_aoi;
+    dst->time_cleanup += src->time_cleanup;
+    dst->time_frames += src->time_frames;
+}
+
+#ifdef GAR_STATS
+/******************************************************************************/
+uint64_t gar_stats_allocs( void )
+{
+    return gar_stats_alloc_count;
+}
+#endif
+
+/******************************************************************************/
+double gar_stats_now( void )
+{
+    struct timespec ts;
+
+    clock_gettime( CLOCK_MONOTONIC, &ts );
+
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+#ifdef GAR_STATS
+/******************************************************************************/
+void* __wrap_calloc( size_t count, size_t size )
+{
+    gar_stats_alloc_count++;
+    return __real_calloc( count, size );
+}
+
+/******************************************************************************/
+void* __wrap_malloc( size_t size )
+{
+    gar_stats_alloc_count++;
+    return __real_malloc( size );
+}
+
+/******************************************************************************/
+void* __wrap_realloc( void* ptr, size_t size )
+{
+    gar_stats_alloc_count++;
+    return __real_realloc( ptr, size );
+}
+#endif
@@ -0,0 +1,112 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef GAR_STATS_H
+#define GAR_STATS_H
+
+#include <stdint.h>
+
+/**
+ * The instrumentation is only compiled if GAR_STATS is defined (e.g. by
+ * adding `-DGAR_STATS` to PKG_CPPFLAGS in `src/Makevars`). Otherwise the
+ * macros below expand to nothing. Heap allocations are counted by wrapping
+ * malloc, calloc, and realloc at link time (see `src/Makevars`) which covers
+ * the allocations of the wrapper and of the statically linked libgac.
+ */
+#ifdef GAR_STATS
+#define GAR_STATS_DECLARE( t ) double t
+#define GAR_STATS_DECLARE_ALLOCS( a ) uint64_t a
+#define GAR_STATS_ALLOCS_START( a ) do { \
+    ( a ) = gar_stats_allocs(); \
+} while( 0 )
+#define GAR_STATS_ALLOCS_STOP( stats, a ) do { \
+    ( stats )->allocs += gar_stats_allocs() - ( a ); \
+} while( 0 )
+#define GAR_STATS_START( t ) do { \
+    ( t ) = gar_stats_now(); \
+} while( 0 )
+#define GAR_STATS_STOP( stats, field, t ) do { \
+    ( stats )->field += gar_stats_now() - ( t ); \
+} while( 0 )
+#define GAR_STATS_COUNT( stats, field, n ) do { \
+    ( stats )->field += ( n ); \
+} while( 0 )
+#else
+#define GAR_STATS_DECLARE( t )
+#define GAR_STATS_DECLARE_ALLOCS( a )
+#define GAR_STATS_ALLOCS_START( a ) do {} while( 0 )
+#define GAR_STATS_ALLOCS_STOP( stats, a ) do {} while( 0 )
+#define GAR_STATS_START( t ) do {} while( 0 )
+#define GAR_STATS_STOP( stats, field, t ) do {} while( 0 )
+#define GAR_STATS_COUNT( stats, field, n ) do {} while( 0 )
+#endif
+
+/** Counters and timers of the parser stages. */
+typedef struct gar_stats_s gar_stats_t;
+
+/**
+ * Counters and timers of the parser stages. All times are in seconds.
+ */
+struct gar_stats_s
+{
+    /** The number of samples passed to the sample window. */
+    uint64_t samples_in;
+    /** The number of samples added to the sample window, including the
+     * samples interpolated by the gap filter. */
+    uint64_t samples_added;
+    /** The number of detected fixations. */
+    uint64_t fixations;
+    /** The number of detected saccades. */
+    uint64_t saccades;
+    /** The number of AOI analysis entries. */
+    uint64_t analyses;
+    /** The number of fixation-AOI hit tests. */
+    uint64_t aoi_tests;
+    /** The number of heap allocations while samples were parsed. */
+    uint64_t allocs;
+    /** The time spent in the sample window update (gap and noise filter). */
+    double time_update;
+    /** The time spent in the saccade filter. */
+    double time_saccade;
+    /** The time spent in the fixation filter. */
+    double time_fixation;
+    /** The time spent in the AOI analysis. */
+    double time_aoi;
+    /** The time spent in the sample window cleanup. */
+    double time_cleanup;
+    /** The time spent to build the R data frames. */
+    double time_frames;
+};
+
+/**
+ * Add the counters and timers of a statistics structure to another one.
+ *
+ * @param dst
+ *  A pointer to the statistics to add to.
+ * @param src
+ *  A pointer to the statistics to add.
+ */
+void gar_stats_add( gar_stats_t* dst, gar_stats_t* src );
+
+/**
+ * Get the number of heap allocations of the calling thread. Only available if
+ * GAR_STATS is defined.
+ *
+ * @return
+ *  The number of calls to malloc, calloc, and realloc made by the calling
+ *  thread since it was started.
+ */
+uint64_t gar_stats_allocs( void );
+
+/**
+ * Read the monotonic clock.
+ *
+ * @return
+ *  The current time in seconds.
+ */
+double gar_stats_now( void );
+
+#endif
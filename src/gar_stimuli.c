@@ -0,0 +1,135 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include "gar_stimuli.h"
+#include <stdlib.h>
+#include <string.h>
+
+/******************************************************************************/
+bool gar_stimuli_add_aoi( gar_stimuli_t* stimuli, gac_t* gac, uint32_t id,
+        gac_aoi_t* aoi )
+{
+    uint32_t i;
+    gac_aoi_collection_t* sets;
+
+    if( id == GAR_LABEL_BLANK )
+    {
+        stimuli->has_blank = true;
+    }
+
+    if( id == stimuli->active )
+    {
+        return gac_add_aoi( gac, aoi );
+    }
+
+    if( id >= stimuli->count )
+    {
+        sets = realloc( stimuli->sets,
+                ( id + 1 ) * sizeof( gac_aoi_collection_t ) );
+        if( sets == NULL )
+        {
+            return false;
+        }
+        stimuli->sets = sets;
+        for( i = stimuli->count; i <= id; i++ )
+        {
+            memset( &sets[i], 0, sizeof( gac_aoi_collection_t ) );
+            if( i != stimuli->active && !gac_aoi_collection_init( &sets[i] ) )
+            {
+                stimuli->count = i;
+                return false;
+            }
+        }
+        stimuli->count = id + 1;
+    }
+
+    return gac_aoi_collection_add( &stimuli->sets[id], aoi );
+}
+
+/******************************************************************************/
+void gar_stimuli_destroy( gar_stimuli_t* stimuli )
+{
+    uint32_t i;
+
+    for( i = 0; i < stimuli->count; i++ )
+    {
+        if( i != stimuli->active )
+        {
+            gac_aoi_collection_destroy( &stimuli->sets[i] );
+        }
+    }
+    free( stimuli->sets );
+    stimuli->sets = NULL;
+    stimuli->count = 0;
+}
+
+/******************************************************************************/
+uint32_t gar_stimuli_find( gar_stimuli_t* stimuli, const char* label )
+{
+    uint32_t id;
+    const char* key;
+
+    if( stimuli->count <= 1 )
+    {
+        return GAR_LABEL_BLANK;
+    }
+
+    // consecutive fixations mostly share their label
+    key = stimuli->keys->items[stimuli->active];
+    if( *key != '\0' && label != NULL && strcmp( key, label ) == 0 )
+    {
+        return stimuli->active;
+    }
+
+    id = gar_labels_find( stimuli->keys, label );
+    if( id == GAR_LABEL_INVALID || id == GAR_LABEL_BLANK
+            || id >= stimuli->count )
+    {
+        return stimuli->has_blank ? GAR_LABEL_BLANK : GAR_LABEL_INVALID;
+    }
+
+    return id;
+}
+
+/******************************************************************************/
+bool gar_stimuli_has_aoi( gar_stimuli_t* stimuli, gac_t* gac )
+{
+    return gac->aoic.aois.count > 0 || gar_stimuli_has_sets( stimuli );
+}
+
+/******************************************************************************/
+bool gar_stimuli_has_sets( gar_stimuli_t* stimuli )
+{
+    return stimuli != NULL && stimuli->count > 1;
+}
+
+/******************************************************************************/
+void gar_stimuli_init( gar_stimuli_t* stimuli, const gar_labels_t* keys )
+{
+    stimuli->keys = keys;
+    stimuli->sets = NULL;
+    stimuli->count = 0;
+    stimuli->active = GAR_LABEL_BLANK;
+    stimuli->has_blank = false;
+    stimuli->has_trial = false;
+    stimuli->trial_id = 0;
+}
+
+/******************************************************************************/
+void gar_stimuli_select( gar_stimuli_t* stimuli, gac_t* gac, uint32_t id )
+{
+    if( id == stimuli->active )
+    {
+        return;
+    }
+
+    // the collections are moved by value as libgac keeps no pointer into
+    // gac->aoic (see gar_stimuli_t)
+    stimuli->sets[stimuli->active] = gac->aoic;
+    gac->aoic = stimuli->sets[id];
+    memset( &stimuli->sets[id], 0, sizeof( gac_aoi_collection_t ) );
+    stimuli->active = id;
+}
@@ -0,0 +1,146 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef GAR_STIMULI_H
+#define GAR_STIMULI_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "gac.h"
+#include "gac_aoi_collection.h"
+#include "gar_labels.h"
+
+/** The AOI sets of a gac handler, keyed by stimulus. */
+typedef struct gar_stimuli_s gar_stimuli_t;
+
+/**
+ * The AOI sets of a gac handler, keyed by stimulus. Each set is an AOI
+ * collection of its own. The active set is held by the AOI collection of the
+ * gac handler such that the AOI analysis of libgac only tests the AOIs of
+ * the active set. Selecting another set swaps the collections together with
+ * their analysis state such that the open trial of each set is continued
+ * when the set is selected again. The set of the blank stimulus holds the
+ * AOIs which were added without a stimulus and is used for all labels
+ * without a set of their own. If no AOI was added without a stimulus, such
+ * labels are not analysed.
+ *
+ * Swapping the collections by value relies on libgac keeping no pointer into
+ * the AOI collection of a gac handler: the collection is a plain member of
+ * `gac_t` which owns its AOI list, and libgac only reaches it through the
+ * pointer passed to each call (gac_add_aoi() and the
+ * gac_aoi_collection_analyse_*() functions). Neither the sample window, the
+ * filters, nor the detected events refer to it.
+ */
+struct gar_stimuli_s
+{
+    /** The stimulus dictionary where the label ID is the index of the AOI
+     * set. It is shared with the handler configuration and not modified. */
+    const gar_labels_t* keys;
+    /** The AOI collections of the inactive sets. The slot of the active set
+     * is empty. */
+    gac_aoi_collection_t* sets;
+    /** The number of set slots. */
+    uint32_t count;
+    /** The index of the active set. */
+    uint32_t active;
+    /** True if AOIs were added without a stimulus. */
+    bool has_blank;
+    /** True if a fixation was analysed since the sets were last finalised,
+     * false otherwise. */
+    bool has_trial;
+    /** The trial ID of the last analysed fixation. This is only valid if
+     * `has_trial` is true. */
+    uint32_t trial_id;
+};
+
+/**
+ * Add an AOI to an AOI set.
+ *
+ * @param stimuli
+ *  A pointer to the AOI sets.
+ * @param gac
+ *  A pointer to the gac handler holding the active set.
+ * @param id
+ *  The index of the AOI set (the stimulus ID).
+ * @param aoi
+ *  A pointer to the AOI to add. It is owned by the set on success.
+ * @return
+ *  True on success, false on failure.
+ */
+bool gar_stimuli_add_aoi( gar_stimuli_t* stimuli, gac_t* gac, uint32_t id,
+        gac_aoi_t* aoi );
+
+/**
+ * Release the AOI collections of all inactive sets. The active set is
+ * released with the gac handler.
+ *
+ * @param stimuli
+ *  A pointer to the AOI sets.
+ */
+void gar_stimuli_destroy( gar_stimuli_t* stimuli );
+
+/**
+ * Get the index of the AOI set of a label.
+ *
+ * @param stimuli
+ *  A pointer to the AOI sets.
+ * @param label
+ *  The label of a sample or NULL.
+ * @return
+ *  The index of the AOI set registered for the label. If the label has no
+ *  set of its own, the index of the blank set if AOIs were added without a
+ *  stimulus or GAR_LABEL_INVALID otherwise.
+ */
+uint32_t gar_stimuli_find( gar_stimuli_t* stimuli, const char* label );
+
+/**
+ * Check whether a gac handler has any AOI to analyse.
+ *
+ * @param stimuli
+ *  A pointer to the AOI sets of the gac handler or NULL.
+ * @param gac
+ *  A pointer to the gac handler holding the active set.
+ * @return
+ *  True if the AOI analysis is enabled, false otherwise.
+ */
+bool gar_stimuli_has_aoi( gar_stimuli_t* stimuli, gac_t* gac );
+
+/**
+ * Check whether any AOI set besides the blank set exists.
+ *
+ * @param stimuli
+ *  A pointer to the AOI sets or NULL.
+ * @return
+ *  True if AOIs were added under a stimulus, false otherwise.
+ */
+bool gar_stimuli_has_sets( gar_stimuli_t* stimuli );
+
+/**
+ * Initialise an empty list of AOI sets where the blank set is active.
+ *
+ * @param stimuli
+ *  A pointer to the AOI sets to initialise.
+ * @param keys
+ *  A pointer to the stimulus dictionary.
+ */
+void gar_stimuli_init( gar_stimuli_t* stimuli, const gar_labels_t* keys );
+
+/**
+ * Activate an AOI set by swapping its AOI collection with the AOI collection
+ * of the gac handler. The analysis state of the previously active set is
+ * kept in its slot (see gar_stimuli_t for the libgac invariant this relies
+ * on).
+ *
+ * @param stimuli
+ *  A pointer to the AOI sets.
+ * @param gac
+ *  A pointer to the gac handler holding the active set.
+ * @param id
+ *  The index of the AOI set to activate.
+ */
+void gar_stimuli_select( gar_stimuli_t* stimuli, gac_t* gac, uint32_t id );
+
+#endif
@@ -0,0 +1,137 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include "gar_sweep.h"
+#include "gar_thread.h"
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * Evaluate one configuration with a new gac handler.
+ *
+ * @param data
+ *  A pointer to the configuration set.
+ * @param idx
+ *  The index of the configuration to evaluate.
+ * @return
+ *  True on success, false on failure.
+ */
+static bool gar_sweep_parse_job( void* data, uint32_t idx );
+
+/**
+ * Add the events of an event list to a configuration summary.
+ *
+ * @param result
+ *  A pointer to the summary to update.
+ * @param events
+ *  A pointer to the event list to add.
+ */
+static void gar_sweep_summarise( gar_sweep_result_t* result,
+        gar_events_t* events );
+
+/******************************************************************************/
+bool gar_sweep_parse( gar_sweep_t* sweep, uint32_t thread_count )
+{
+    uint32_t i;
+    bool res;
+    gar_batch_t batch;
+
+    sweep->packed = malloc( ( sweep->samples.count > 0
+                ? sweep->samples.count : 1 ) * sizeof( gar_sample_t ) );
+    if( sweep->packed == NULL )
+    {
+        return false;
+    }
+
+    for( i = 0; i < sweep->samples.count; i += batch.count )
+    {
+        gar_batch_slice( &batch, &sweep->samples, i, GAR_BATCH_SIZE );
+        gar_batch_pack( &batch, &sweep->packed[i] );
+    }
+
+    res = gar_thread_run( gar_sweep_parse_job, sweep, sweep->config_count,
+            thread_count );
+
+    free( sweep->packed );
+    sweep->packed = NULL;
+
+    return res;
+}
+
+/******************************************************************************/
+static bool gar_sweep_parse_job( void* data, uint32_t idx )
+{
+    uint32_t i, count;
+    bool res, has_screen;
+    gac_t* gac;
+    gar_stimuli_t stimuli;
+    gar_events_t events;
+    gar_sweep_t* sweep = data;
+    gar_sweep_result_t* result = &sweep->results[idx];
+
+    memset( result, 0, sizeof( gar_sweep_result_t ) );
+
+    if( !gar_events_init( &events, NULL ) )
+    {
+        return false;
+    }
+
+    gac = gar_handler_gac_create_params( sweep->h, &sweep->params[idx],
+            &stimuli );
+    if( gac == NULL )
+    {
+        gar_events_destroy( &events );
+        return false;
+    }
+
+    has_screen = ( sweep->samples.sx != NULL && sweep->samples.sy != NULL )
+        || sweep->samples.screen != NULL;
+    res = true;
+    for( i = 0; res && i < sweep->samples.count; i += count )
+    {
+        count = sweep->samples.count - i;
+        if( count > GAR_BATCH_SIZE )
+        {
+            count = GAR_BATCH_SIZE;
+        }
+        res = gar_batch_parse_samples( gac, &stimuli, &sweep->packed[i],
+                count, has_screen, sweep->samples.labels, &events );
+        gar_sweep_summarise( result, &events );
+        gar_events_clear( &events );
+    }
+
+    if( res )
+    {
+        res = gar_batch_finalise( gac, &stimuli, &events );
+        gar_sweep_summarise( result, &events );
+    }
+
+    gar_stimuli_destroy( &stimuli );
+    gac_destroy( gac );
+    gar_events_destroy( &events );
+
+    return res;
+}
+
+/******************************************************************************/
+static void gar_sweep_summarise( gar_sweep_result_t* result,
+        gar_events_t* events )
+{
+    uint32_t i;
+
+    for( i = 0; i < events->fixation_count; i++ )
+    {
+        result->fixation_duration += events->fixations[i].duration;
+    }
+    for( i = 0; i < events->saccade_count; i++ )
+    {
+        result->saccade_duration += events->saccades[i].duration;
+    }
+    result->fixation_count += events->fixation_count;
+    result->saccade_count += events->saccade_count;
+    result->analysis_count += events->analysis_count;
+    gar_stats_add( &result->stats, &events->stats );
+}
@@ -0,0 +1,77 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef GAR_SWEEP_H
+#define GAR_SWEEP_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "gar_batch.h"
+#include "gar_handler.h"
+
+/** A set of filter configurations which are evaluated on the same samples. */
+typedef struct gar_sweep_s gar_sweep_t;
+/** The summary of the events detected with one filter configuration. */
+typedef struct gar_sweep_result_s gar_sweep_result_t;
+
+/**
+ * The summary of the events detected with one filter configuration.
+ */
+struct gar_sweep_result_s
+{
+    /** The number of detected fixations. */
+    uint32_t fixation_count;
+    /** The number of detected saccades. */
+    uint32_t saccade_count;
+    /** The number of AOI analysis entries. */
+    uint32_t analysis_count;
+    /** The sum of all fixation durations. */
+    double fixation_duration;
+    /** The sum of all saccade durations. */
+    double saccade_duration;
+    /** The parser statistics of the configuration. */
+    gar_stats_t stats;
+};
+
+/**
+ * A set of filter configurations. Each configuration is evaluated by its own
+ * gac handler which holds the screen and the AOIs of the R handler. The
+ * input samples are packed once and the packed records are shared by all
+ * configurations.
+ */
+struct gar_sweep_s
+{
+    /** The handler holding the screen and AOIs to use for each
+     * configuration. */
+    gar_handler_t* h;
+    /** The input sample columns. */
+    gar_batch_t samples;
+    /** The packed input samples. This is only valid during
+     * gar_sweep_parse(). */
+    gar_sample_t* packed;
+    /** The list of filter parameters, one per configuration. */
+    gac_filter_parameter_t* params;
+    /** The number of configurations. */
+    uint32_t config_count;
+    /** The list of results, one per configuration. */
+    gar_sweep_result_t* results;
+};
+
+/**
+ * Evaluate all configurations in parallel. The events are summarised block
+ * by block such that the memory required per configuration does not grow
+ * with the number of events. This function does not use the R API.
+ *
+ * @param sweep
+ *  A pointer to the configuration set to evaluate.
+ * @param thread_count
+ *  The number of worker threads.
+ * @return
+ *  True on success, false on failure.
+ */
+bool gar_sweep_parse( gar_sweep_t* sweep, uint32_t thread_count );
+
+#endif
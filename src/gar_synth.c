@@ -0,0 +1,268 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include "gar_synth.h"
+#include <math.h>
+#include <string.h>
+
+/**
+ * The screen used to compute 3d gaze points: top left, top right, and bottom
+ * left corner (as configured in `example/example.R`).
+ */
+static const double gar_synth_screen[9] = {
+    -298.64031982421875, 331.7396545410156, 113.90633392333984,
+    298.87738037109375, 331.7396545410156, 113.90633392333984,
+    -298.64031982421875, 15.905486106872559, -1.0478993654251099
+};
+
+/** The gaze origin of the synthetic eye. */
+static const double gar_synth_origin[3] = { 9.0, -21.0, 620.0 };
+
+/** The labels cycled through by the generator. */
+static const char* gar_synth_label_names[4] = {
+    "", "stimulus a", "stimulus b", "stimulus c"
+};
+
+/**
+ * Draw a normally distributed random number.
+ *
+ * @param synth
+ *  A pointer to the generator.
+ * @return
+ *  A random number with mean 0 and standard deviation 1.
+ */
+static double gar_synth_normal( gar_synth_t* synth );
+
+/**
+ * Switch to the next eye movement state.
+ *
+ * @param synth
+ *  A pointer to the generator.
+ */
+static void gar_synth_transition( gar_synth_t* synth );
+
+/**
+ * Draw a uniformly distributed random number.
+ *
+ * @param synth
+ *  A pointer to the generator.
+ * @param min
+ *  The lower bound.
+ * @param max
+ *  The upper bound.
+ * @return
+ *  A random number in the range [min, max).
+ */
+static double gar_synth_uniform( gar_synth_t* synth, double min, double max );
+
+/**
+ * Update the trial ID and the label according to the current timestamp.
+ *
+ * @param synth
+ *  A pointer to the generator.
+ */
+static void gar_synth_update_trial( gar_synth_t* synth );
+
+/******************************************************************************/
+void gar_synth_fill( gar_synth_t* synth, gar_batch_buffer_t* buffer,
+        uint32_t count )
+{
+    uint32_t i = 0;
+    double s[2];
+    double progress;
+    double period = 1000.0 / synth->params.rate;
+    const double* c = gar_synth_screen;
+
+    while( i < count )
+    {
+        while( synth->state_left <= 0 )
+        {
+            gar_synth_transition( synth );
+        }
+
+        gar_synth_update_trial( synth );
+
+        if( synth->state != GAR_SYNTH_STATE_GAP )
+        {
+            if( synth->state == GAR_SYNTH_STATE_FIXATION )
+            {
+                s[0] = synth->target[0]
+                    + synth->params.fixation_noise * gar_synth_normal( synth );
+                s[1] = synth->target[1]
+                    + synth->params.fixation_noise * gar_synth_normal( synth );
+            }
+            else
+            {
+                progress = 1 - synth->state_left / synth->state_duration;
+                s[0] = synth->from[0]
+                    + ( synth->target[0] - synth->from[0] ) * progress;
+                s[1] = synth->from[1]
+                    + ( synth->target[1] - synth->from[1] ) * progress;
+            }
+
+            buffer->sx[i] = s[0];
+            buffer->sy[i] = s[1];
+            buffer->px[i] = c[0] + s[0] * ( c[3] - c[0] )
+                + s[1] * ( c[6] - c[0] );
+            buffer->py[i] = c[1] + s[0] * ( c[4] - c[1] )
+                + s[1] * ( c[7] - c[1] );
+            buffer->pz[i] = c[2] + s[0] * ( c[5] - c[2] )
+                + s[1] * ( c[8] - c[2] );
+            buffer->ox[i] = gar_synth_origin[0] + gar_synth_normal( synth );
+            buffer->oy[i] = gar_synth_origin[1] + gar_synth_normal( synth );
+            buffer->oz[i] = gar_synth_origin[2] + gar_synth_normal( synth );
+            buffer->timestamp[i] = synth->timestamp;
+            buffer->trial_id[i] = synth->trial_id;
+            buffer->label[i] = synth->label;
+
+            if( synth->params.nan_rate > 0
+                    && gar_synth_uniform( synth, 0, 1 ) < synth->params.nan_rate )
+            {
+                buffer->sx[i] = NAN;
+                buffer->sy[i] = NAN;
+                buffer->px[i] = NAN;
+                buffer->py[i] = NAN;
+                buffer->pz[i] = NAN;
+                buffer->ox[i] = NAN;
+                buffer->oy[i] = NAN;
+                buffer->oz[i] = NAN;
+            }
+            i++;
+        }
+
+        synth->timestamp += period;
+        synth->state_left -= period;
+    }
+}
+
+/******************************************************************************/
+bool gar_synth_init( gar_synth_t* synth, gar_synth_parameter_t* params,
+        gar_labels_t* labels )
+{
+    uint32_t i;
+
+    memset( synth, 0, sizeof( gar_synth_t ) );
+    synth->params = *params;
+    synth->rng = params->seed * 0x9E3779B97F4A7C15ull + 1;
+
+    for( i = 0; i < 4; i++ )
+    {
+        synth->labels[i] = gar_labels_intern( labels,
+                gar_synth_label_names[i] );
+        if( synth->labels[i] == GAR_LABEL_INVALID )
+        {
+            return false;
+        }
+    }
+
+    synth->target[0] = gar_synth_uniform( synth, 0.05, 0.95 );
+    synth->target[1] = gar_synth_uniform( synth, 0.05, 0.95 );
+    synth->state = GAR_SYNTH_STATE_FIXATION;
+    synth->state_duration = gar_synth_uniform( synth, params->fixation_min,
+            params->fixation_max );
+    synth->state_left = synth->state_duration;
+    synth->label = synth->labels[0];
+
+    return true;
+}
+
+/******************************************************************************/
+static double gar_synth_normal( gar_synth_t* synth )
+{
+    double u = gar_synth_uniform( synth, 1e-12, 1 );
+    double v = gar_synth_uniform( synth, 0, 1 );
+
+    return sqrt( -2 * log( u ) ) * cos( 2 * M_PI * v );
+}
+
+/******************************************************************************/
+void gar_synth_parameter_default( gar_synth_parameter_t* params, double rate )
+{
+    params->rate = rate;
+    params->fixation_min = 150;
+    params->fixation_max = 600;
+    params->fixation_noise = 0.003;
+    params->saccade_min = 20;
+    params->saccade_max = 60;
+    params->gap_rate = 0.1;
+    params->gap_min = 100;
+    params->gap_max = 300;
+    params->nan_rate = 0;
+    params->trial_duration = 10000;
+    params->label_duration = 2500;
+    params->seed = 1;
+}
+
+/******************************************************************************/
+static void gar_synth_transition( gar_synth_t* synth )
+{
+    gar_synth_parameter_t* p = &synth->params;
+
+    switch( synth->state )
+    {
+        case GAR_SYNTH_STATE_FIXATION:
+            if( gar_synth_uniform( synth, 0, 1 ) < p->gap_rate )
+            {
+                synth->state = GAR_SYNTH_STATE_GAP;
+                synth->state_duration = gar_synth_uniform( synth, p->gap_min,
+                        p->gap_max );
+            }
+            else
+            {
+                synth->state = GAR_SYNTH_STATE_SACCADE;
+                synth->state_duration = gar_synth_uniform( synth,
+                        p->saccade_min, p->saccade_max );
+                synth->from[0] = synth->target[0];
+                synth->from[1] = synth->target[1];
+                synth->target[0] = gar_synth_uniform( synth, 0.05, 0.95 );
+                synth->target[1] = gar_synth_uniform( synth, 0.05, 0.95 );
+            }
+            break;
+        case GAR_SYNTH_STATE_GAP:
+            synth->target[0] = gar_synth_uniform( synth, 0.05, 0.95 );
+            synth->target[1] = gar_synth_uniform( synth, 0.05, 0.95 );
+            /* fall through */
+        case GAR_SYNTH_STATE_SACCADE:
+            synth->state = GAR_SYNTH_STATE_FIXATION;
+            synth->state_duration = gar_synth_uniform( synth, p->fixation_min,
+                    p->fixation_max );
+            break;
+    }
+
+    synth->state_left += synth->state_duration;
+}
+
+/******************************************************************************/
+static double gar_synth_uniform( gar_synth_t* synth, double min, double max )
+{
+    uint64_t x = synth->rng;
+
+    x ^= x >> 12;
+    x ^= x << 25;
+    x ^= x >> 27;
+    synth->rng = x;
+
+    return min + ( max - min )
+        * ( ( x * 0x2545F4914F6CDD1Dull ) >> 11 ) * 0x1.0p-53;
+}
+
+/******************************************************************************/
+static void gar_synth_update_trial( gar_synth_t* synth )
+{
+    uint64_t idx;
+
+    if( synth->params.trial_duration > 0 )
+    {
+        synth->trial_id = ( int32_t )( synth->timestamp
+                / synth->params.trial_duration );
+    }
+
+    if( synth->params.label_duration > 0 )
+    {
+        idx = ( uint64_t )( synth->timestamp / synth->params.label_duration );
+        synth->label = synth->labels[idx % 4];
+    }
+}
@@ -0,0 +1,138 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef GAR_SYNTH_H
+#define GAR_SYNTH_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "gar_batch.h"
+#include "gar_labels.h"
+
+/** A generator of synthetic gaze samples. */
+typedef struct gar_synth_s gar_synth_t;
+/** The configuration of the synthetic gaze generator. */
+typedef struct gar_synth_parameter_s gar_synth_parameter_t;
+/** The eye movement states of the synthetic gaze generator. */
+typedef enum gar_synth_state_e gar_synth_state_t;
+
+/**
+ * The eye movement states of the synthetic gaze generator.
+ */
+enum gar_synth_state_e
+{
+    GAR_SYNTH_STATE_FIXATION,
+    GAR_SYNTH_STATE_SACCADE,
+    GAR_SYNTH_STATE_GAP
+};
+
+/**
+ * The configuration of the synthetic gaze generator. All durations are in
+ * milliseconds.
+ */
+struct gar_synth_parameter_s
+{
+    /** The sample rate in Hz. */
+    double rate;
+    /** The minimal duration of a fixation. */
+    double fixation_min;
+    /** The maximal duration of a fixation. */
+    double fixation_max;
+    /** The standard deviation of the normalized gaze jitter. */
+    double fixation_noise;
+    /** The minimal duration of a saccade. */
+    double saccade_min;
+    /** The maximal duration of a saccade. */
+    double saccade_max;
+    /** The probability of a gap (blink or tracking loss) after a fixation. */
+    double gap_rate;
+    /** The minimal duration of a gap. */
+    double gap_min;
+    /** The maximal duration of a gap. */
+    double gap_max;
+    /** The fraction of samples where all coordinates are NaN. */
+    double nan_rate;
+    /** The duration of a trial. Zero disables trial changes. */
+    double trial_duration;
+    /** The duration of a label. Zero disables label changes. */
+    double label_duration;
+    /** The seed of the random number generator. */
+    uint64_t seed;
+};
+
+/**
+ * A generator of synthetic gaze samples. The gaze alternates between
+ * fixations on random screen targets and linear saccades between the targets.
+ * Gaps are modelled as time spans without samples.
+ */
+struct gar_synth_s
+{
+    /** The configuration. */
+    gar_synth_parameter_t params;
+    /** The state of the random number generator. */
+    uint64_t rng;
+    /** The current eye movement state. */
+    gar_synth_state_t state;
+    /** The time left in the current state. */
+    double state_left;
+    /** The duration of the current state. */
+    double state_duration;
+    /** The normalized screen position where the current saccade started. */
+    double from[2];
+    /** The normalized screen position of the current fixation target. */
+    double target[2];
+    /** The timestamp of the next sample. */
+    double timestamp;
+    /** The ID of the current trial. */
+    int32_t trial_id;
+    /** The ID of the current label in the label dictionary. */
+    uint32_t label;
+    /** The label IDs of the label cycle. */
+    uint32_t labels[4];
+};
+
+/**
+ * Initialise the synthetic gaze generator.
+ *
+ * @param synth
+ *  A pointer to the generator to initialise.
+ * @param params
+ *  A pointer to the configuration.
+ * @param labels
+ *  The dictionary to intern the sample labels into.
+ * @return
+ *  True on success, false on failure.
+ */
+bool gar_synth_init( gar_synth_t* synth, gar_synth_parameter_t* params,
+        gar_labels_t* labels );
+
+/**
+ * Fill a batch buffer with the next samples of the synthetic gaze stream.
+ *
+ * @param synth
+ *  A pointer to the generator.
+ * @param buffer
+ *  A pointer to the batch buffer to fill.
+ * @param count
+ *  The number of samples to generate. This must not exceed GAR_BATCH_SIZE.
+ */
+void gar_synth_fill( gar_synth_t* synth, gar_batch_buffer_t* buffer,
+        uint32_t count );
+
+/**
+ * Initialise a configuration with the default values: fixations of 150 to
+ * 600 ms with a jitter of 0.003, saccades of 20 to 60 ms, a gap after 10% of
+ * fixations lasting 100 to 300 ms, no NaN samples, trials of 10 s, and labels
+ * of 2.5 s.
+ *
+ * @param params
+ *  A pointer to the configuration to initialise.
+ * @param rate
+ *  The sample rate in Hz.
+ */
+void gar_synth_parameter_default( gar_synth_parameter_t* params, double rate );
+
+#endif
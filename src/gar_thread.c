@@ -0,0 +1,159 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include "gar_thread.h"
+#include <pthread.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+/** The shared state of all worker threads of one gar_thread_run() call. */
+typedef struct gar_thread_pool_s gar_thread_pool_t;
+
+/**
+ * The shared state of the worker threads.
+ */
+struct gar_thread_pool_s
+{
+    /** The job function. */
+    gar_thread_job_t job;
+    /** The data pointer passed to the job function. */
+    void* data;
+    /** The number of jobs. */
+    uint32_t job_count;
+    /** The index of the next job to execute. */
+    uint32_t next;
+    /** False if any job failed. */
+    bool res;
+    /** The lock protecting the job index and the result. */
+    pthread_mutex_t lock;
+};
+
+/**
+ * The worker thread function. It executes jobs until no job is left.
+ *
+ * @param arg
+ *  A pointer to the shared pool state.
+ * @return
+ *  NULL
+ */
+static void* gar_thread_worker( void* arg );
+
+/******************************************************************************/
+uint32_t gar_thread_count( int requested, uint32_t job_count )
+{
+    long count = requested;
+
+    if( count <= 0 )
+    {
+#ifdef _SC_NPROCESSORS_ONLN
+        count = sysconf( _SC_NPROCESSORS_ONLN );
+#endif
+        if( count <= 0 )
+        {
+            count = 1;
+        }
+    }
+
+    if( ( uint32_t )count > job_count )
+    {
+        count = job_count;
+    }
+
+    return count > 0 ? ( uint32_t )count : 1;
+}
+
+/******************************************************************************/
+bool gar_thread_run( gar_thread_job_t job, void* data, uint32_t job_count,
+        uint32_t thread_count )
+{
+    uint32_t i, started;
+    pthread_t* threads;
+    gar_thread_pool_t pool;
+
+    pool.job = job;
+    pool.data = data;
+    pool.job_count = job_count;
+    pool.next = 0;
+    pool.res = true;
+
+    if( thread_count <= 1 || job_count <= 1 )
+    {
+        for( i = 0; i < job_count; i++ )
+        {
+            if( !job( data, i ) )
+            {
+                pool.res = false;
+            }
+        }
+        return pool.res;
+    }
+
+    threads = malloc( thread_count * sizeof( pthread_t ) );
+    if( threads == NULL )
+    {
+        return false;
+    }
+
+    pthread_mutex_init( &pool.lock, NULL );
+    started = 0;
+    for( i = 0; i < thread_count; i++ )
+    {
+        if( pthread_create( &threads[i], NULL, gar_thread_worker, &pool ) != 0 )
+        {
+            break;
+        }
+        started++;
+    }
+
+    if( started == 0 )
+    {
+        // no thread could be started, work on the calling thread
+        gar_thread_worker( &pool );
+    }
+
+    for( i = 0; i < started; i++ )
+    {
+        pthread_join( threads[i], NULL );
+    }
+    pthread_mutex_destroy( &pool.lock );
+    free( threads );
+
+    return pool.res;
+}
+
+/******************************************************************************/
+static void* gar_thread_worker( void* arg )
+{
+    uint32_t idx;
+    bool res;
+    gar_thread_pool_t* pool = arg;
+
+    while( true )
+    {
+        pthread_mutex_lock( &pool->lock );
+        idx = pool->next;
+        if( idx < pool->job_count )
+        {
+            pool->next++;
+        }
+        pthread_mutex_unlock( &pool->lock );
+
+        if( idx >= pool->job_count )
+        {
+            break;
+        }
+
+        res = pool->job( pool->data, idx );
+        if( !res )
+        {
+            pthread_mutex_lock( &pool->lock );
+            pool->res = false;
+            pthread_mutex_unlock( &pool->lock );
+        }
+    }
+
+    return NULL;
+}
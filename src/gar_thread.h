@@ -0,0 +1,59 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef GAR_THREAD_H
+#define GAR_THREAD_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/**
+ * A job function which is executed by a worker thread. Job functions must
+ * not use the R API.
+ *
+ * @param data
+ *  The data pointer passed to gar_thread_run().
+ * @param idx
+ *  The index of the job to execute.
+ * @return
+ *  True on success, false on failure.
+ */
+typedef bool ( *gar_thread_job_t )( void* data, uint32_t idx );
+
+/**
+ * Get the number of worker threads to use.
+ *
+ * @param requested
+ *  The requested number of threads. If this is zero or negative the number
+ *  of online processors is used.
+ * @param job_count
+ *  The number of jobs. No more threads than jobs are used.
+ * @return
+ *  The number of worker threads, at least one.
+ */
+uint32_t gar_thread_count( int requested, uint32_t job_count );
+
+/**
+ * Execute a set of jobs on a pool of worker threads. Each job index in
+ * `[0, job_count)` is executed exactly once. The function returns after all
+ * jobs have been executed. If only one thread is requested, the jobs are
+ * executed on the calling thread.
+ *
+ * @param job
+ *  The job function.
+ * @param data
+ *  An arbitrary data pointer which is passed to each job.
+ * @param job_count
+ *  The number of jobs.
+ * @param thread_count
+ *  The number of worker threads.
+ * @return
+ *  True if all jobs succeeded, false otherwise.
+ */
+bool gar_thread_run( gar_thread_job_t job, void* data, uint32_t job_count,
+        uint32_t thread_count );
+
+#endif
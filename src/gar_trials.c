@@ -0,0 +1,264 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include "gar_trials.h"
+#include "gar_thread.h"
+#include <math.h>
+#include <stdlib.h>
+
+/** The state of one block while it is parsed. */
+typedef struct gar_trials_block_s gar_trials_block_t;
+
+/**
+ * The state of one block while it is parsed.
+ */
+struct gar_trials_block_s
+{
+    /** The gac handler parsing the block. */
+    gac_t* gac;
+    /** The AOI sets of the gac handler. */
+    gar_stimuli_t stimuli;
+    /** The event list of the block. */
+    gar_events_t* events;
+    /** True if the AOI analysis is enabled, false otherwise. */
+    bool has_aoi;
+    /** The timestamp of the first sample of the block. */
+    double begin;
+    /** The timestamp of the first sample after the block. */
+    double end;
+    /** True until the first fixation of the block is detected. Saccades
+     * before it belong to the trial which is still open in the previous
+     * block. */
+    bool leading;
+    /** True once the first fixation after the block is detected. Saccades
+     * after the block and before this fixation belong to the last trial of
+     * the block. */
+    bool closed;
+};
+
+/**
+ * Check whether an event starts within a block.
+ *
+ * @param block
+ *  A pointer to the block state.
+ * @param timestamp
+ *  The timestamp of the first sample of the event.
+ * @return
+ *  True if the event belongs to the block, false otherwise.
+ */
+static bool gar_trials_contains( gar_trials_block_t* block,
+        double timestamp );
+
+/**
+ * Run the AOI analysis on a detected event if it belongs to the block (see
+ * gar_batch_defer_t). A fixation belongs to the block if it starts within
+ * the block. As the AOI analysis only switches trials on fixations, a
+ * saccade belongs to the trial which is open when it is detected: saccades
+ * from the first fixation of the block up to the first fixation after the
+ * block belong to the block. All other events of the margins are dropped.
+ *
+ * @param data
+ *  A pointer to the block state.
+ * @param saccade
+ *  A pointer to the detected saccade or NULL.
+ * @param fixation
+ *  A pointer to the detected fixation or NULL.
+ * @return
+ *  True on success, false on failure.
+ */
+static bool gar_trials_defer( void* data, gac_saccade_t* saccade,
+        gac_fixation_t* fixation );
+
+/**
+ * Parse one block and its margins with a new gac handler.
+ *
+ * @param data
+ *  A pointer to the block set.
+ * @param idx
+ *  The index of the block to parse.
+ * @return
+ *  True on success, false on failure.
+ */
+static bool gar_trials_parse_job( void* data, uint32_t idx );
+
+/**
+ * Remove all fixations and saccades from the event list which do not start
+ * within the block.
+ *
+ * @param block
+ *  A pointer to the block state.
+ */
+static void gar_trials_trim( gar_trials_block_t* block );
+
+/******************************************************************************/
+static bool gar_trials_contains( gar_trials_block_t* block,
+        double timestamp )
+{
+    return timestamp >= block->begin && timestamp < block->end;
+}
+
+/******************************************************************************/
+static bool gar_trials_defer( void* data, gac_saccade_t* saccade,
+        gac_fixation_t* fixation )
+{
+    bool res = true;
+    double timestamp;
+    gar_trials_block_t* block = data;
+
+    if( fixation != NULL )
+    {
+        timestamp = fixation->first_sample.timestamp;
+        if( timestamp >= block->end )
+        {
+            block->closed = true;
+        }
+        else if( timestamp >= block->begin )
+        {
+            block->leading = false;
+            if( block->has_aoi )
+            {
+                res = gar_batch_analyse_fixation( block->gac,
+                        &block->stimuli, fixation, block->events );
+            }
+        }
+        gac_fixation_destroy( fixation );
+    }
+    else
+    {
+        timestamp = saccade->first_sample.timestamp;
+        if( block->has_aoi && timestamp >= block->begin && !block->leading
+                && !block->closed )
+        {
+            gar_batch_analyse_saccade( block->gac, &block->stimuli, saccade,
+                    block->events );
+        }
+        gac_saccade_destroy( saccade );
+    }
+
+    return res;
+}
+
+/******************************************************************************/
+bool gar_trials_parse( gar_trials_t* trials, uint32_t thread_count )
+{
+    return gar_thread_run( gar_trials_parse_job, trials, trials->block_count,
+            thread_count );
+}
+
+/******************************************************************************/
+static bool gar_trials_parse_job( void* data, uint32_t idx )
+{
+    uint32_t start, end, first, last;
+    bool res;
+    gar_batch_t range;
+    gar_trials_block_t block;
+    gar_trials_t* trials = data;
+    gar_batch_t* samples = &trials->samples;
+    const double* timestamp = samples->timestamp;
+
+    block.events = &trials->events[idx];
+    if( !gar_events_init( block.events, NULL ) )
+    {
+        return false;
+    }
+
+    block.gac = gar_handler_gac_create( trials->h, &block.stimuli );
+    if( block.gac == NULL )
+    {
+        return false;
+    }
+    block.has_aoi = gar_stimuli_has_aoi( &block.stimuli, block.gac );
+
+    start = trials->offsets[idx];
+    end = trials->offsets[idx + 1];
+    block.begin = ( start > 0 ) ? timestamp[start] : -INFINITY;
+    block.end = ( end < samples->count ) ? timestamp[end] : INFINITY;
+    block.leading = start > 0;
+    block.closed = false;
+
+    first = start;
+    while( first > 0 && timestamp[first - 1] >= block.begin - trials->margin )
+    {
+        first--;
+    }
+    last = end;
+    while( last < samples->count
+            && timestamp[last] < block.end + trials->margin )
+    {
+        last++;
+    }
+
+    gar_batch_slice( &range, samples, first, last - first );
+    res = gar_batch_parse_columns( block.gac, &block.stimuli, &range,
+            block.has_aoi, block.events, gar_trials_defer, &block );
+
+    if( res )
+    {
+        res = gar_batch_finalise( block.gac, &block.stimuli,
+                block.events );
+        gar_trials_trim( &block );
+    }
+
+    gar_stimuli_destroy( &block.stimuli );
+    gac_destroy( block.gac );
+
+    return res;
+}
+
+/******************************************************************************/
+void gar_trials_split( gar_trials_t* trials, uint32_t max_block_count )
+{
+    uint32_t i, target, count;
+    const int* trial_id = trials->samples.trial_id;
+    uint32_t len = trials->samples.count;
+
+    trials->offsets[0] = 0;
+    trials->block_count = 0;
+    if( len == 0 || max_block_count == 0 )
+    {
+        return;
+    }
+
+    target = len / max_block_count + ( len % max_block_count > 0 );
+    count = 0;
+    for( i = 1; i < len && count + 1 < max_block_count; i++ )
+    {
+        if( trial_id[i] != trial_id[i - 1]
+                && i - trials->offsets[count] >= target )
+        {
+            trials->offsets[++count] = i;
+        }
+    }
+    trials->offsets[++count] = len;
+    trials->block_count = count;
+}
+
+/******************************************************************************/
+static void gar_trials_trim( gar_trials_block_t* block )
+{
+    uint32_t i, count;
+    gar_events_t* events = block->events;
+
+    count = 0;
+    for( i = 0; i < events->fixation_count; i++ )
+    {
+        if( gar_trials_contains( block, events->fixations[i].timestamp ) )
+        {
+            events->fixations[count++] = events->fixations[i];
+        }
+    }
+    events->fixation_count = count;
+
+    count = 0;
+    for( i = 0; i < events->saccade_count; i++ )
+    {
+        if( gar_trials_contains( block, events->saccades[i].timestamp ) )
+        {
+            events->saccades[count++] = events->saccades[i];
+        }
+    }
+    events->saccade_count = count;
+}
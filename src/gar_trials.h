@@ -0,0 +1,77 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef GAR_TRIALS_H
+#define GAR_TRIALS_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "gar_batch.h"
+#include "gar_handler.h"
+
+/** The number of trial blocks created per worker thread such that threads
+ * which finish early pick up the remaining blocks. */
+#define GAR_TRIALS_BLOCKS_PER_THREAD 4
+
+/** A recording split into blocks of consecutive trials. */
+typedef struct gar_trials_s gar_trials_t;
+
+/**
+ * A recording split into blocks of consecutive trials. Each block is parsed
+ * by its own gac handler which is configured like the gac handler of the R
+ * handler. To fill the sample window as the sequential parser would, the
+ * samples within the margin before and after a block are parsed along with
+ * the block. Of the detected events only those starting within the block
+ * are kept and analysed for AOIs (see gar_trials_defer() for the saccades
+ * between two blocks).
+ */
+struct gar_trials_s
+{
+    /** The handler holding the configuration to use for each block. */
+    gar_handler_t* h;
+    /** The complete input sample columns. The timestamps must be
+     * ascending. */
+    gar_batch_t samples;
+    /** The offsets of the blocks in the sample columns. This holds one more
+     * element than there are blocks. */
+    uint32_t* offsets;
+    /** The number of blocks. */
+    uint32_t block_count;
+    /** The time in milliseconds before and after a block of which the
+     * samples are parsed along with the block. */
+    double margin;
+    /** The list of event lists, one per block. It must be zero-initialised
+     * and is initialised while parsing. */
+    gar_events_t* events;
+};
+
+/**
+ * Parse all blocks in parallel. The events of each block are stored in the
+ * event list of the block. This function does not use the R API.
+ *
+ * @param trials
+ *  A pointer to the block set to parse.
+ * @param thread_count
+ *  The number of worker threads.
+ * @return
+ *  True on success, false on failure.
+ */
+bool gar_trials_parse( gar_trials_t* trials, uint32_t thread_count );
+
+/**
+ * Split the samples into blocks of consecutive trials of about equal size.
+ * A block boundary is only placed where the trial ID changes. The offsets
+ * and the number of blocks are stored in the block set.
+ *
+ * @param trials
+ *  A pointer to the block set. The offset list must hold at least
+ *  `max_block_count + 1` elements.
+ * @param max_block_count
+ *  The maximal number of blocks.
+ */
+void gar_trials_split( gar_trials_t* trials, uint32_t max_block_count );
+
+#endif
@@ -5,7 +5,20 @@
  */
 
 #include "wrapper.h"
+#include "gar_csv.h"
+#include "gar_frame.h"
+#include "gar_group.h"
+#include "gar_pipeline.h"
+#include "gar_sweep.h"
+#include "gar_synth.h"
+#include "gar_thread.h"
+#include "gar_trials.h"
 #include <Rdefines.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/resource.h>
+#include <time.h>
 
 static SEXP gac_type_tag;
 
@@ -16,15 +29,13 @@ static SEXP gac_type_tag;
 } while( 0 )
 
 /******************************************************************************/
-SEXP gar_add_aoi_points( SEXP ptr, SEXP points, SEXP label )
+SEXP gar_add_aoi_points( SEXP ptr, SEXP points, SEXP label, SEXP stimulus )
 {
-    gac_t* h;
-    int32_t i;
+    gar_handler_t* h;
     SEXP rlabel;
     SEXP x, y;
-    double *px, *py;
     const char* clabel;
-    gac_aoi_t aoi;
+    const char* cstimulus;
 
     CHECK_GAC_HANDLER( ptr );
     h = R_ExternalPtrAddr( ptr );
@@ -41,6 +52,12 @@ SEXP gar_add_aoi_points( SEXP ptr, SEXP points, SEXP label )
         return R_NilValue;
     }
 
+    if( stimulus != R_NilValue && !Rf_isString( stimulus ) )
+    {
+        error( "stimulus needs to be of type string" );
+        return R_NilValue;
+    }
+
     if( !Rf_isFrame( points ) )
     {
         error( "AOI points need to be passed as dataframe" );
@@ -63,26 +80,29 @@ SEXP gar_add_aoi_points( SEXP ptr, SEXP points, SEXP label )
         clabel = CHAR( rlabel );
     }
 
-    gac_aoi_init( &aoi, clabel );
+    cstimulus = NULL;
+    if( stimulus != R_NilValue && !Rf_StringBlank( STRING_ELT( stimulus, 0 ) ) )
+    {
+        cstimulus = CHAR( STRING_ELT( stimulus, 0 ) );
+    }
 
-    px = REAL( x );
-    py = REAL( y );
-    for( i = 0; i < Rf_length( x ); i++ )
+    if( !gar_handler_add_aoi_points( h, clabel, cstimulus, REAL( x ),
+                REAL( y ), Rf_length( x ) ) )
     {
-        gac_aoi_add_point( &aoi, px[i], py[i] );
+        error( "failed to add AOI" );
+        return R_NilValue;
     }
-    gac_add_aoi( h, &aoi );
 
     return R_NilValue;
 }
 
 /******************************************************************************/
 SEXP gar_add_aoi_rectangle( SEXP ptr, SEXP x, SEXP y, SEXP width, SEXP height,
-        SEXP label )
+        SEXP label, SEXP stimulus )
 {
     const char* clabel;
-    gac_t* h;
-    gac_aoi_t aoi;
+    const char* cstimulus;
+    gar_handler_t* h;
     CHECK_GAC_HANDLER( ptr );
     SEXP rlabel;
 
@@ -101,6 +121,12 @@ SEXP gar_add_aoi_rectangle( SEXP ptr, SEXP x, SEXP y, SEXP width, SEXP height,
         return R_NilValue;
     }
 
+    if( stimulus != R_NilValue && !Rf_isString( stimulus ) )
+    {
+        error( "stimulus needs to be of type string" );
+        return R_NilValue;
+    }
+
     h = R_ExternalPtrAddr( ptr );
     clabel = NULL;
     rlabel = STRING_ELT( label, 0 );
@@ -109,154 +135,253 @@ SEXP gar_add_aoi_rectangle( SEXP ptr, SEXP x, SEXP y, SEXP width, SEXP height,
         clabel = CHAR( rlabel );
     }
 
-    gac_aoi_init( &aoi, clabel );
-    gac_aoi_add_rect( &aoi, Rf_asReal( x ), Rf_asReal( y ), Rf_asReal( width ),
-            Rf_asReal( height ) );
-    gac_add_aoi( h, &aoi );
+    cstimulus = NULL;
+    if( stimulus != R_NilValue && !Rf_StringBlank( STRING_ELT( stimulus, 0 ) ) )
+    {
+        cstimulus = CHAR( STRING_ELT( stimulus, 0 ) );
+    }
+
+    if( !gar_handler_add_aoi_rect( h, clabel, cstimulus, Rf_asReal( x ),
+                Rf_asReal( y ), Rf_asReal( width ), Rf_asReal( height ) ) )
+    {
+        error( "failed to add AOI" );
+        return R_NilValue;
+    }
 
     return R_NilValue;
 }
 
 /******************************************************************************/
-SEXP gar_analysis_frame_create( uint32_t count )
-{
-    const char* names[] = { "trial_id", "trial_timestamp", "dwell_time",
-        "dwell_time_rel", "first_fixation_duration", "first_fixation_onset",
-        "prior_aoi_visited_count", "first_saccade_start_onset",
-        "first_saccade_end_onset", "first_saccade_latency",
-        "saccade_enter_count", "fixation_count_rel", "fixation_count",
-        "aoi_name", "label_onset", "" };
-
-    SEXP df = PROTECT( Rf_mkNamed( VECSXP, names ) );
-
-    SEXP trial_id = PROTECT( Rf_allocVector( INTSXP, count ) );
-    SEXP trial_timestamp = PROTECT( Rf_allocVector( REALSXP, count ) );
-    SEXP dwell_time = PROTECT( Rf_allocVector( REALSXP, count ) );
-    SEXP dwell_time_rel = PROTECT( Rf_allocVector( REALSXP, count ) );
-    SEXP first_fixation_duration = PROTECT( Rf_allocVector( REALSXP, count ) );
-    SEXP first_fixation_onset = PROTECT( Rf_allocVector( REALSXP, count ) );
-    SEXP prior_aoi_visited_count = PROTECT( Rf_allocVector( INTSXP, count ) );
-    SEXP first_saccade_start = PROTECT( Rf_allocVector( REALSXP, count ) );
-    SEXP first_saccade_end = PROTECT( Rf_allocVector( REALSXP, count ) );
-    SEXP first_saccade_latency = PROTECT( Rf_allocVector( REALSXP, count ) );
-    SEXP saccade_enter_count = PROTECT( Rf_allocVector( INTSXP, count ) );
-    SEXP fixation_count_rel = PROTECT( Rf_allocVector( REALSXP, count ) );
-    SEXP fixation_count = PROTECT( Rf_allocVector( INTSXP, count ) );
-    SEXP aoi_label = PROTECT( Rf_allocVector( STRSXP, count ) );
-    SEXP label_onset = PROTECT( Rf_allocVector( REALSXP, count ) );
-
-    SET_VECTOR_ELT( df, 0, trial_id );
-    SET_VECTOR_ELT( df, 1, trial_timestamp );
-    SET_VECTOR_ELT( df, 2, dwell_time );
-    SET_VECTOR_ELT( df, 3, dwell_time_rel );
-    SET_VECTOR_ELT( df, 4, first_fixation_duration );
-    SET_VECTOR_ELT( df, 5, first_fixation_onset );
-    SET_VECTOR_ELT( df, 6, prior_aoi_visited_count );
-    SET_VECTOR_ELT( df, 7, first_saccade_start );
-    SET_VECTOR_ELT( df, 8, first_saccade_end );
-    SET_VECTOR_ELT( df, 9, first_saccade_latency );
-    SET_VECTOR_ELT( df, 10, saccade_enter_count );
-    SET_VECTOR_ELT( df, 11, fixation_count_rel );
-    SET_VECTOR_ELT( df, 12, fixation_count );
-    SET_VECTOR_ELT( df, 13, aoi_label );
-    SET_VECTOR_ELT( df, 14, label_onset );
-    UNPROTECT( 15 );
+SEXP gar_add_aois( SEXP ptr, SEXP aoi_id, SEXP x, SEXP y, SEXP label,
+        SEXP stimulus, SEXP aoi_count )
+{
+    uint32_t i, len, count;
+    uint32_t* ids;
+    const char** labels;
+    const char** stimuli;
+    gar_handler_t* h;
+    SEXP rlabel;
 
-    SET_CLASS( df, mkString( "data.frame" ) );
+    CHECK_GAC_HANDLER( ptr );
+    h = R_ExternalPtrAddr( ptr );
 
-    SEXP rownames = PROTECT( allocVector( INTSXP, 2 ) );
-    SET_INTEGER_ELT( rownames, 0, NA_INTEGER );
-    SET_INTEGER_ELT( rownames, 1, -count );
-    setAttrib( df, R_RowNamesSymbol, rownames );
-    UNPROTECT( 1 );
+    if( h == NULL )
+    {
+        error( "gac handler is NULL" );
+        return R_NilValue;
+    }
 
-    return df;
+    if( !Rf_isInteger( aoi_id ) || !Rf_isReal( x ) || !Rf_isReal( y ) )
+    {
+        error( "AOI IDs need to be integers and coordinates need to be doubles" );
+        return R_NilValue;
+    }
+
+    len = Rf_length( aoi_id );
+    if( ( uint32_t )Rf_length( x ) != len
+            || ( uint32_t )Rf_length( y ) != len )
+    {
+        error( "AOI columns need to be of equal length" );
+        return R_NilValue;
+    }
+
+    count = Rf_asInteger( aoi_count );
+    if( label != R_NilValue
+            && ( !Rf_isString( label )
+                || ( uint32_t )Rf_length( label ) != count ) )
+    {
+        error( "AOI labels need to be of type string with one label per AOI" );
+        return R_NilValue;
+    }
+
+    if( stimulus != R_NilValue
+            && ( !Rf_isString( stimulus )
+                || ( uint32_t )Rf_length( stimulus ) != count ) )
+    {
+        error( "AOI stimuli need to be of type string with one stimulus per AOI" );
+        return R_NilValue;
+    }
+
+    ids = ( uint32_t* )R_alloc( len > 0 ? len : 1, sizeof( uint32_t ) );
+    for( i = 0; i < len; i++ )
+    {
+        if( INTEGER( aoi_id )[i] < 1
+                || ( uint32_t )INTEGER( aoi_id )[i] > count )
+        {
+            error( "AOI index out of range" );
+            return R_NilValue;
+        }
+        ids[i] = INTEGER( aoi_id )[i] - 1;
+    }
+
+    labels = NULL;
+    if( label != R_NilValue )
+    {
+        labels = ( const char** )R_alloc( count > 0 ? count : 1,
+                sizeof( const char* ) );
+        for( i = 0; i < count; i++ )
+        {
+            labels[i] = NULL;
+            rlabel = STRING_ELT( label, i );
+            if( rlabel != NA_STRING && !Rf_StringBlank( rlabel ) )
+            {
+                labels[i] = CHAR( rlabel );
+            }
+        }
+    }
+
+    stimuli = NULL;
+    if( stimulus != R_NilValue )
+    {
+        stimuli = ( const char** )R_alloc( count > 0 ? count : 1,
+                sizeof( const char* ) );
+        for( i = 0; i < count; i++ )
+        {
+            stimuli[i] = NULL;
+            rlabel = STRING_ELT( stimulus, i );
+            if( rlabel != NA_STRING && !Rf_StringBlank( rlabel ) )
+            {
+                stimuli[i] = CHAR( rlabel );
+            }
+        }
+    }
+
+    if( !gar_handler_add_aois( h, ids, REAL( x ), REAL( y ), len, labels,
+                stimuli, count ) )
+    {
+        error( "failed to add AOIs" );
+        return R_NilValue;
+    }
+
+    return R_NilValue;
 }
 
 /******************************************************************************/
-void gar_analysis_frame_resize( SEXP df, uint32_t new_length )
+SEXP gar_benchmark( SEXP ptr, SEXP n, SEXP rate, SEXP gap_rate,
+        SEXP nan_rate, SEXP trial_duration, SEXP label_duration, SEXP seed )
 {
-    SETLENGTH( VECTOR_ELT( df, 0 ), new_length );
-    SETLENGTH( VECTOR_ELT( df, 1 ), new_length );
-    SETLENGTH( VECTOR_ELT( df, 2 ), new_length );
-    SETLENGTH( VECTOR_ELT( df, 3 ), new_length );
-    SETLENGTH( VECTOR_ELT( df, 4 ), new_length );
-    SETLENGTH( VECTOR_ELT( df, 5 ), new_length );
-    SETLENGTH( VECTOR_ELT( df, 6 ), new_length );
-    SETLENGTH( VECTOR_ELT( df, 7 ), new_length );
-    SETLENGTH( VECTOR_ELT( df, 8 ), new_length );
-    SETLENGTH( VECTOR_ELT( df, 9 ), new_length );
-    SETLENGTH( VECTOR_ELT( df, 10 ), new_length );
-    SETLENGTH( VECTOR_ELT( df, 11 ), new_length );
-    SETLENGTH( VECTOR_ELT( df, 12 ), new_length );
-    SETLENGTH( VECTOR_ELT( df, 13 ), new_length );
-    SETLENGTH( VECTOR_ELT( df, 14 ), new_length );
+    SEXP ret;
+    gar_handler_t* h;
+    gac_t* gac;
+    gar_stimuli_t stimuli;
+    bool res;
+    uint32_t count;
+    double i, len;
+    double fixations, saccades, analyses, allocs;
+    struct timespec start, end;
+    struct rusage usage;
+    gar_synth_t synth;
+    gar_synth_parameter_t params;
+    gar_batch_t batch;
+    gar_batch_buffer_t* buffer;
+    gar_events_t events;
+    const char* names[] = { "samples", "fixations", "saccades", "aoi",
+        "seconds", "samples_per_sec", "events_per_sec", "peak_rss_kb",
+        "allocs", "" };
 
-    SEXP rownames = PROTECT( allocVector( INTSXP, 2 ) );
-    SET_INTEGER_ELT( rownames, 0, NA_INTEGER );
-    SET_INTEGER_ELT( rownames, 1, -new_length );
-    setAttrib( df, R_RowNamesSymbol, rownames );
+    CHECK_GAC_HANDLER( ptr );
+    len = Rf_asReal( n );
+    if( ISNAN( len ) || len < 0 )
+    {
+        error( "the sample count needs to be a positive number" );
+    }
+    gar_synth_parameter_parse( &params, rate, gap_rate, nan_rate,
+            trial_duration, label_duration, seed );
+
+    h = R_ExternalPtrAddr( ptr );
+
+    buffer = malloc( sizeof( gar_batch_buffer_t ) );
+    if( buffer == NULL || !gar_events_init( &events, NULL ) )
+    {
+        free( buffer );
+        error( "failed to allocate memory for the detected events" );
+        return R_NilValue;
+    }
+
+    gac = gar_handler_gac_create( h, &stimuli );
+    res = gac != NULL && gar_synth_init( &synth, &params, &events.labels );
+    gar_batch_buffer_attach( &batch, buffer, true, &events.labels );
+
+    fixations = 0;
+    saccades = 0;
+    analyses = 0;
+    allocs = 0;
+    clock_gettime( CLOCK_MONOTONIC, &start );
+    for( i = 0; res && i < len; i += count )
+    {
+        count = ( len - i < GAR_BATCH_SIZE ) ? len - i : GAR_BATCH_SIZE;
+        gar_synth_fill( &synth, buffer, count );
+        batch.count = count;
+        res = gar_batch_parse( gac, &stimuli, &batch, &events );
+        if( res && i + count >= len )
+        {
+            res = gar_batch_finalise( gac, &stimuli, &events );
+        }
+        fixations += events.fixation_count;
+        saccades += events.saccade_count;
+        analyses += events.analysis_count;
+        allocs += events.stats.allocs;
+        gar_stats_add( &h->stats, &events.stats );
+        gar_events_clear( &events );
+    }
+    clock_gettime( CLOCK_MONOTONIC, &end );
+    getrusage( RUSAGE_SELF, &usage );
+
+    gar_stimuli_destroy( &stimuli );
+    if( gac != NULL )
+    {
+        gac_destroy( gac );
+    }
+    gar_events_destroy( &events );
+    free( buffer );
+
+    if( !res )
+    {
+        error( "failed to allocate memory for the detected events" );
+        return R_NilValue;
+    }
+
+    ret = PROTECT( Rf_mkNamed( REALSXP, names ) );
+    REAL( ret )[0] = len;
+    REAL( ret )[1] = fixations;
+    REAL( ret )[2] = saccades;
+    REAL( ret )[3] = analyses;
+    REAL( ret )[4] = ( end.tv_sec - start.tv_sec )
+        + ( end.tv_nsec - start.tv_nsec ) * 1e-9;
+    REAL( ret )[5] = len / REAL( ret )[4];
+    REAL( ret )[6] = ( fixations + saccades ) / REAL( ret )[4];
+    REAL( ret )[7] = usage.ru_maxrss;
+#ifdef GAR_STATS
+    REAL( ret )[8] = allocs;
+#else
+    REAL( ret )[8] = NA_REAL;
+#endif
     UNPROTECT( 1 );
-}
 
-/******************************************************************************/
-void gar_analysis_frame_unprotect( SEXP df )
-{
-    UNPROTECT_PTR( df );
+    return ret;
 }
 
 /******************************************************************************/
-void gar_analysis_frame_update( SEXP df, uint32_t* idx,
-        gac_aoi_collection_analysis_result_t* analysis )
+SEXP gar_clone( SEXP ptr )
 {
-    const char* label;
-    uint32_t i;
-    gac_aoi_analysis_t* aoi = NULL;
-    double trial_timestamp;
-    double label_timestamp;
-    double first_saccade_start_onset;
-    double first_saccade_end_onset;
-    double first_saccade_latency;
-    double first_fixation_onset;
-    double label_onset;
-
-    for( i = 0; i < analysis->aois.count; i++ )
-    {
-        aoi = &analysis->aois.items[i].analysis;
-        label = analysis->aois.items[i].label;
-        trial_timestamp = gac_sample_get_trial_timestamp(
-                &aoi->first_fixation.first_sample );
-        label_timestamp = gac_sample_get_label_timestamp(
-                &aoi->first_fixation.first_sample );
-        first_saccade_start_onset = gac_sample_get_onset(
-                &aoi->first_saccade.first_sample, trial_timestamp );
-        first_saccade_end_onset = gac_sample_get_onset(
-                &aoi->first_saccade.last_sample, trial_timestamp );
-        first_fixation_onset = gac_sample_get_onset(
-                &aoi->first_fixation.first_sample, trial_timestamp );
-        label_onset = label_timestamp - trial_timestamp;
-        if( label_onset < 0 )
-        {
-            label_onset = 0;
-        }
-        first_saccade_latency = first_saccade_start_onset - label_onset;
-        INTEGER( VECTOR_ELT( df, 0 ) )[*idx] = analysis->trial_id;
-        REAL( VECTOR_ELT( df, 1 ) )[*idx] = trial_timestamp;
-        REAL( VECTOR_ELT( df, 2 ) )[*idx] = aoi->dwell_time;
-        REAL( VECTOR_ELT( df, 3 ) )[*idx] = aoi->dwell_time_relative;
-        REAL( VECTOR_ELT( df, 4 ) )[*idx] = aoi->first_fixation.duration;
-        REAL( VECTOR_ELT( df, 5 ) )[*idx] = first_fixation_onset;
-        INTEGER( VECTOR_ELT( df, 6 ) )[*idx] = aoi->aoi_visited_before_count;
-        REAL( VECTOR_ELT( df, 7 ) )[*idx] = first_saccade_start_onset;
-        REAL( VECTOR_ELT( df, 8 ) )[*idx] = first_saccade_end_onset;
-        REAL( VECTOR_ELT( df, 9 ) )[*idx] = first_saccade_latency;
-        INTEGER( VECTOR_ELT( df, 10 ) )[*idx] = aoi->enter_saccade_count;
-        REAL( VECTOR_ELT( df, 11 ) )[*idx] = aoi->fixation_count_relative;
-        INTEGER( VECTOR_ELT( df, 12 ) )[*idx] = aoi->fixation_count;
-        SET_STRING_ELT( VECTOR_ELT( df, 13 ), *idx, Rf_mkChar( label ) );
-        REAL( VECTOR_ELT( df, 14 ) )[*idx] = label_onset;
-        ( *idx )++;
+    gar_handler_t* h;
+    gar_handler_t* clone;
+    SEXP ret;
+
+    CHECK_GAC_HANDLER( ptr );
+
+    h = R_ExternalPtrAddr( ptr );
+    clone = gar_handler_clone( h );
+    if( clone == NULL )
+    {
+        error( "failed to clone the gaze analysis handler" );
+        return R_NilValue;
     }
+
+    ret = R_MakeExternalPtr( clone, gac_type_tag, R_NilValue );
+    R_RegisterCFinalizer( ret, ( R_CFinalizer_t )gar_destroy );
+
+    return ret;
 }
 
 /******************************************************************************/
@@ -324,7 +449,7 @@ SEXP gar_create( SEXP r_params )
         }
     }
 
-    h = gac_create( &params );
+    h = gar_handler_create( &params );
     if( h == NULL )
     {
         return R_NilValue;
@@ -372,104 +497,58 @@ SEXP gar_filter_parameter_create( gac_filter_parameter_t* params )
 }
 
 /******************************************************************************/
-SEXP gar_fixation_frame_create( uint32_t count )
+SEXP gar_frame_group_add( SEXP df, uint32_t* counts, uint32_t group_count,
+        SEXP levels )
 {
-    const char* names[] = { "sx", "sy", "px", "py", "pz", "duration",
-        "timestamp", "trial_id", "trial_onset", "label", "label_onset", "" };
-
-    SEXP df = PROTECT( Rf_mkNamed( VECSXP, names ) );
-
-    SEXP sx = PROTECT( Rf_allocVector( REALSXP, count ) );
-    SEXP sy = PROTECT( Rf_allocVector( REALSXP, count ) );
-    SEXP px = PROTECT( Rf_allocVector( REALSXP, count ) );
-    SEXP py = PROTECT( Rf_allocVector( REALSXP, count ) );
-    SEXP pz = PROTECT( Rf_allocVector( REALSXP, count ) );
-    SEXP duration = PROTECT( Rf_allocVector( REALSXP, count ) );
-    SEXP timestamp = PROTECT( Rf_allocVector( REALSXP, count ) );
-    SEXP trial_onset = PROTECT( Rf_allocVector( REALSXP, count ) );
-    SEXP label_onset = PROTECT( Rf_allocVector( REALSXP, count ) );
-    SEXP trial_id = PROTECT( Rf_allocVector( INTSXP, count ) );
-    SEXP label = PROTECT( Rf_allocVector( STRSXP, count ) );
-
-    SET_VECTOR_ELT( df, 0, sx );
-    SET_VECTOR_ELT( df, 1, sy );
-    SET_VECTOR_ELT( df, 2, px );
-    SET_VECTOR_ELT( df, 3, py );
-    SET_VECTOR_ELT( df, 4, pz );
-    SET_VECTOR_ELT( df, 5, duration );
-    SET_VECTOR_ELT( df, 6, timestamp );
-    SET_VECTOR_ELT( df, 7, trial_id );
-    SET_VECTOR_ELT( df, 8, trial_onset );
-    SET_VECTOR_ELT( df, 9, label );
-    SET_VECTOR_ELT( df, 10, label_onset );
-    UNPROTECT( 11 );
-
-    SET_CLASS( df, mkString( "data.frame" ) );
-
-    SEXP rownames = PROTECT( allocVector( INTSXP, 2 ) );
-    SET_INTEGER_ELT( rownames, 0, NA_INTEGER );
-    SET_INTEGER_ELT( rownames, 1, -count );
-    setAttrib( df, R_RowNamesSymbol, rownames );
-    UNPROTECT( 1 );
-
-    return df;
-}
+    SEXP ret, names, df_names, group;
+    uint32_t i, j, k, len;
+    int* codes;
 
-/******************************************************************************/
-void gar_fixation_frame_resize( SEXP df, uint32_t new_length )
-{
-    SETLENGTH( VECTOR_ELT( df, 0 ), new_length );
-    SETLENGTH( VECTOR_ELT( df, 1 ), new_length );
-    SETLENGTH( VECTOR_ELT( df, 2 ), new_length );
-    SETLENGTH( VECTOR_ELT( df, 3 ), new_length );
-    SETLENGTH( VECTOR_ELT( df, 4 ), new_length );
-    SETLENGTH( VECTOR_ELT( df, 5 ), new_length );
-    SETLENGTH( VECTOR_ELT( df, 6 ), new_length );
-    SETLENGTH( VECTOR_ELT( df, 7 ), new_length );
-    SETLENGTH( VECTOR_ELT( df, 8 ), new_length );
-    SETLENGTH( VECTOR_ELT( df, 9 ), new_length );
-    SETLENGTH( VECTOR_ELT( df, 10 ), new_length );
+    len = Rf_length( df );
+    df_names = Rf_getAttrib( df, R_NamesSymbol );
 
-    SEXP rownames = PROTECT( allocVector( INTSXP, 2 ) );
-    SET_INTEGER_ELT( rownames, 0, NA_INTEGER );
-    SET_INTEGER_ELT( rownames, 1, -new_length );
-    setAttrib( df, R_RowNamesSymbol, rownames );
-    UNPROTECT( 1 );
-}
+    ret = PROTECT( Rf_allocVector( VECSXP, len + 1 ) );
+    names = PROTECT( Rf_allocVector( STRSXP, len + 1 ) );
+    for( i = 0; i < len; i++ )
+    {
+        SET_VECTOR_ELT( ret, i, VECTOR_ELT( df, i ) );
+        SET_STRING_ELT( names, i, STRING_ELT( df_names, i ) );
+    }
 
-/******************************************************************************/
-void gar_fixation_frame_unprotect( SEXP df )
-{
-    UNPROTECT_PTR( df );
-}
+    k = 0;
+    for( i = 0; i < group_count; i++ )
+    {
+        k += counts[i];
+    }
+    group = PROTECT( Rf_allocVector( INTSXP, k ) );
+    codes = INTEGER( group );
+    k = 0;
+    for( i = 0; i < group_count; i++ )
+    {
+        for( j = 0; j < counts[i]; j++ )
+        {
+            codes[k++] = i + 1;
+        }
+    }
+    setAttrib( group, R_LevelsSymbol, levels );
+    SET_CLASS( group, mkString( "factor" ) );
 
-/******************************************************************************/
-void gar_fixation_frame_update( SEXP df, uint32_t idx,
-        gac_fixation_t* fixation )
-{
-    const char* label = fixation->first_sample.label;
+    SET_VECTOR_ELT( ret, len, group );
+    SET_STRING_ELT( names, len, Rf_mkChar( "group" ) );
+    setAttrib( ret, R_NamesSymbol, names );
+    SET_CLASS( ret, mkString( "data.frame" ) );
+    setAttrib( ret, R_RowNamesSymbol,
+            Rf_getAttrib( df, R_RowNamesSymbol ) );
+    UNPROTECT( 3 );
 
-    REAL( VECTOR_ELT( df, 0 ) )[idx] = fixation->screen_point[0];
-    REAL( VECTOR_ELT( df, 1 ) )[idx] = fixation->screen_point[1];
-    REAL( VECTOR_ELT( df, 2 ) )[idx] = fixation->point[0];
-    REAL( VECTOR_ELT( df, 3 ) )[idx] = fixation->point[1];
-    REAL( VECTOR_ELT( df, 4 ) )[idx] = fixation->point[2];
-    REAL( VECTOR_ELT( df, 5 ) )[idx] = fixation->duration;
-    REAL( VECTOR_ELT( df, 6 ) )[idx] = fixation->first_sample.timestamp;
-    INTEGER( VECTOR_ELT( df, 7 ) )[idx] = fixation->first_sample.trial_id;
-    REAL( VECTOR_ELT( df, 8 ) )[idx] = fixation->first_sample.trial_onset;
-    SET_STRING_ELT( VECTOR_ELT( df, 9 ), idx, Rf_mkChar( label ) );
-    REAL( VECTOR_ELT( df, 10 ) )[idx] = fixation->first_sample.label_onset;
+    return ret;
 }
 
 /******************************************************************************/
 SEXP gar_get_filter_parameter( SEXP ptr )
 {
-    void* h = R_ExternalPtrAddr( ptr );
-    gac_filter_parameter_t params;
-
-    gac_get_filter_parameter( h, &params );
-    return gar_filter_parameter_create( &params );
+    gar_handler_t* h = R_ExternalPtrAddr( ptr );
+    return gar_filter_parameter_create( &h->params );
 }
 
 /******************************************************************************/
@@ -482,334 +561,1198 @@ SEXP gar_get_filter_parameter_default()
 }
 
 /******************************************************************************/
-SEXP gar_init( void )
-{
-    gac_type_tag = install( "GAC_TYPE_TAG" );
-    return R_NilValue;
-}
-
-/******************************************************************************/
-SEXP gar_parse( SEXP ptr, SEXP px, SEXP py, SEXP pz, SEXP ox, SEXP oy, SEXP oz,
-        SEXP sx, SEXP sy, SEXP timestamp, SEXP trial_id, SEXP label )
+SEXP gar_get_latency( SEXP ptr, SEXP reset )
 {
-    SEXP ret, fixations, saccades, rlabel, aoi = NULL;
-    const char* clabel;
-    const char* names[] = { "fixations", "saccades", "aoi", "" };
-    gac_t* h;
-    int32_t len, i;
-    uint32_t j;
-    int *ptrial_id;
-    double *psx, *psy, *ppx, *ppy, *ppz, *pox, *poy, *poz, *ptimestamp;
-    bool res;
-    gac_fixation_t fixation;
-    uint32_t fixation_count = 0;
-    gac_saccade_t saccade;
-    uint32_t saccade_count = 0;
-    gac_aoi_collection_analysis_result_t analysis;
-    uint32_t analysis_count = 0;
-    uint32_t new_sample_count = 0;
+    SEXP ret, summary, hist, rownames;
+    gar_handler_t* h;
+    gar_latency_t* latency;
+    uint32_t i, k, bin_count;
+    const char* names[] = { "summary", "histogram", "" };
+    const char* summary_names[] = { "count", "mean", "p50", "p90", "p99",
+        "max", "" };
+    const char* hist_names[] = { "lower", "upper", "count", "" };
 
     CHECK_GAC_HANDLER( ptr );
 
-    if( !Rf_isReal( px )
-        || !Rf_isReal( py )
-        || !Rf_isReal( pz )
-        || ( sx != R_NilValue && !Rf_isReal( sx ) )
-        || ( sy != R_NilValue && !Rf_isReal( sy ) )
-        || !Rf_isReal( ox )
-        || !Rf_isReal( oy )
-        || !Rf_isReal( oz )
-        || !Rf_isReal( timestamp ) )
-    {
-        error( "all point and timestamp vectors need to be of type double" );
-        return R_NilValue;
-    }
-
-    if( !Rf_isInteger( trial_id ) )
-    {
-        error( "trial ID vector needs to be of type integer" );
-        return R_NilValue;
-    }
-
-    if( !Rf_isString( label ) )
-    {
-        error( "label vector needs to be of type string" );
-        return R_NilValue;
-    }
-
-    len = Rf_length( timestamp );
-
-    if( Rf_length( px ) != len
-        || Rf_length( py ) != len
-        || Rf_length( pz ) != len
-        || ( sx != R_NilValue && Rf_length( sx ) != len )
-        || ( sx != R_NilValue && Rf_length( sy ) != len )
-        || Rf_length( ox ) != len
-        || Rf_length( oy ) != len
-        || Rf_length( oz ) != len
-        || Rf_length( trial_id ) != len
-        || Rf_length( label ) != len )
-    {
-        error( "all vectors need to be of the same length" );
-        return R_NilValue;
-    }
-
     h = R_ExternalPtrAddr( ptr );
-
-    psx = NULL;
-    if( sx != R_NilValue )
-    {
-        psx = REAL( sx );
-    }
-    psy = NULL;
-    if( sy != R_NilValue )
+    latency = &h->online.latency;
+
+    summary = PROTECT( Rf_mkNamed( REALSXP, summary_names ) );
+    REAL( summary )[0] = latency->count;
+    REAL( summary )[1] = ( latency->count > 0 )
+        ? 1000 * latency->sum / latency->count : NA_REAL;
+    REAL( summary )[2] = 1000 * gar_latency_quantile( latency, 0.5 );
+    REAL( summary )[3] = 1000 * gar_latency_quantile( latency, 0.9 );
+    REAL( summary )[4] = 1000 * gar_latency_quantile( latency, 0.99 );
+    REAL( summary )[5] = ( latency->count > 0 ) ? 1000 * latency->max
+        : NA_REAL;
+
+    bin_count = 0;
+    for( i = 0; i < GAR_LATENCY_BIN_COUNT; i++ )
     {
-        psy = REAL( sy );
-    }
-    ppx = REAL( px );
-    ppy = REAL( py );
-    ppz = REAL( pz );
-    pox = REAL( ox );
-    poy = REAL( oy );
-    poz = REAL( oz );
-    ptimestamp = REAL( timestamp );
-    ptrial_id = INTEGER( trial_id );
-    fixations = gar_fixation_frame_create( len );
-    saccades = gar_saccade_frame_create( len );
-    if( h->aoic.aois.count > 0 )
-    {
-        aoi = gar_analysis_frame_create( len );
-    }
-    for( i = 0; i < len; i++ )
-    {
-        rlabel = STRING_ELT( label, i );
-        clabel = NULL;
-        if( !Rf_StringBlank( rlabel ) )
-        {
-            clabel = CHAR( rlabel );
-        }
-        if( psx != NULL && psy != NULL )
-        {
-            new_sample_count = gac_sample_window_update_screen( h,
-                    ( float )pox[i], ( float )poy[i], ( float )poz[i],
-                    ( float )ppx[i], ( float )ppy[i], ( float )ppz[i],
-                    ( float )psx[i], ( float )psy[i],
-                    ptimestamp[i], ptrial_id[i], clabel );
-        }
-        else
-        {
-            new_sample_count = gac_sample_window_update( h,
-                    ( float )pox[i], ( float )poy[i], ( float )poz[i],
-                    ( float )ppx[i], ( float )ppy[i], ( float )ppz[i],
-                    ptimestamp[i], ptrial_id[i], clabel );
-        }
-        for( j = 0; j < new_sample_count; j++ )
+        if( latency->bins[i] > 0 )
         {
-            res = gac_sample_window_saccade_filter( h, &saccade );
-            if( res )
-            {
-                gar_saccade_frame_update( saccades, saccade_count, &saccade );
-                if( h->aoic.aois.count > 0 )
-                {
-                    gac_aoi_collection_analyse_saccade( &h->aoic, &saccade );
-                }
-                gac_saccade_destroy( &saccade );
-                saccade_count++;
-            }
-            res = gac_sample_window_fixation_filter( h, &fixation );
-            if( res )
-            {
-                gar_fixation_frame_update( fixations, fixation_count, &fixation );
-                if( h->aoic.aois.count > 0 )
-                {
-                    res = gac_aoi_collection_analyse_fixation( &h->aoic, &fixation,
-                            &analysis );
-                    if( res )
-                    {
-                        gar_analysis_frame_update( aoi, &analysis_count, &analysis );
-                    }
-                }
-                gac_fixation_destroy( &fixation );
-                fixation_count++;
-            }
+            bin_count++;
         }
-        gac_sample_window_cleanup( h );
     }
 
-    if( h->aoic.aois.count > 0 )
+    hist = PROTECT( Rf_mkNamed( VECSXP, hist_names ) );
+    SET_VECTOR_ELT( hist, 0, Rf_allocVector( REALSXP, bin_count ) );
+    SET_VECTOR_ELT( hist, 1, Rf_allocVector( REALSXP, bin_count ) );
+    SET_VECTOR_ELT( hist, 2, Rf_allocVector( REALSXP, bin_count ) );
+    k = 0;
+    for( i = 0; i < GAR_LATENCY_BIN_COUNT; i++ )
     {
-        res = gac_aoi_collection_analyse_finalise( &h->aoic, &analysis );
-        if( res )
+        if( latency->bins[i] == 0 )
         {
-            gar_analysis_frame_update( aoi, &analysis_count, &analysis );
+            continue;
         }
+        REAL( VECTOR_ELT( hist, 0 ) )[k] = 1000 * gar_latency_bin_lower( i );
+        REAL( VECTOR_ELT( hist, 1 ) )[k] = 1000 * gar_latency_bin_upper( i );
+        REAL( VECTOR_ELT( hist, 2 ) )[k] = latency->bins[i];
+        k++;
     }
+    SET_CLASS( hist, mkString( "data.frame" ) );
 
-    gar_fixation_frame_resize( fixations, fixation_count );
-    gar_saccade_frame_resize( saccades, saccade_count );
-    if( h->aoic.aois.count > 0 )
-    {
-        gar_analysis_frame_resize( aoi, analysis_count );
-    }
+    rownames = PROTECT( allocVector( INTSXP, 2 ) );
+    SET_INTEGER_ELT( rownames, 0, NA_INTEGER );
+    SET_INTEGER_ELT( rownames, 1, -bin_count );
+    setAttrib( hist, R_RowNamesSymbol, rownames );
 
     ret = PROTECT( Rf_mkNamed( VECSXP, names ) );
-    SET_VECTOR_ELT( ret, 0, fixations );
-    SET_VECTOR_ELT( ret, 1, saccades );
-    if( h->aoic.aois.count > 0 )
-    {
-        SET_VECTOR_ELT( ret, 2, aoi );
-    }
-    UNPROTECT( 1 );
+    SET_VECTOR_ELT( ret, 0, summary );
+    SET_VECTOR_ELT( ret, 1, hist );
+    UNPROTECT( 4 );
 
-    gar_fixation_frame_unprotect( fixations );
-    gar_saccade_frame_unprotect( saccades );
-    if( h->aoic.aois.count > 0 )
+    if( Rf_asLogical( reset ) == TRUE )
     {
-        gar_analysis_frame_unprotect( aoi );
+        gar_latency_reset( latency );
     }
 
     return ret;
 }
 
 /******************************************************************************/
-SEXP gar_set_screen( SEXP ptr,
-        SEXP top_left_x, SEXP top_left_y, SEXP top_left_z,
-        SEXP top_right_x, SEXP top_right_y, SEXP top_right_z,
-        SEXP bottom_left_x, SEXP bottom_left_y, SEXP bottom_left_z )
+SEXP gar_get_stats( SEXP ptr )
 {
-    void* h = R_ExternalPtrAddr( ptr );
-
-    gac_set_screen( h, Rf_asReal( top_left_x ), Rf_asReal( top_left_y ),
-            Rf_asReal( top_left_z ), Rf_asReal( top_right_x ),
-            Rf_asReal( top_right_y ), Rf_asReal( top_right_z ),
-            Rf_asReal( bottom_left_x ), Rf_asReal( bottom_left_y ),
-            Rf_asReal( bottom_left_z ) );
-
-    return R_NilValue;
-}
+    SEXP ret;
+    gar_handler_t* h;
+    const char* names[] = { "samples_in", "samples_added",
+        "samples_interpolated", "fixations", "saccades", "aoi", "aoi_tests",
+        "allocs", "time_update", "time_saccade", "time_fixation", "time_aoi",
+        "time_cleanup", "time_frames", "" };
 
-/******************************************************************************/
-SEXP gar_saccade_frame_create( uint32_t count )
-{
-    const char* names[] = { "start_screen_x", "start_screen_y", "start_x",
-        "start_y", "start_z", "dest_screen_x", "dest_screen_y", "dest_x",
-        "dest_y", "dest_z", "duration", "timestamp", "trial_id", "trial_onset",
-        "label", "label_onset", "" };
-
-    SEXP df = PROTECT( Rf_mkNamed( VECSXP, names ) );
-    SEXP startscreenx = PROTECT( Rf_allocVector( REALSXP, count ) );
-    SEXP startscreeny = PROTECT( Rf_allocVector( REALSXP, count ) );
-    SEXP startx = PROTECT( Rf_allocVector( REALSXP, count ) );
-    SEXP starty = PROTECT( Rf_allocVector( REALSXP, count ) );
-    SEXP startz = PROTECT( Rf_allocVector( REALSXP, count ) );
-    SEXP destscreenx = PROTECT( Rf_allocVector( REALSXP, count ) );
-    SEXP destscreeny = PROTECT( Rf_allocVector( REALSXP, count ) );
-    SEXP destx = PROTECT( Rf_allocVector( REALSXP, count ) );
-    SEXP desty = PROTECT( Rf_allocVector( REALSXP, count ) );
-    SEXP destz = PROTECT( Rf_allocVector( REALSXP, count ) );
-    SEXP duration = PROTECT( Rf_allocVector( REALSXP, count ) );
-    SEXP timestamp = PROTECT( Rf_allocVector( REALSXP, count ) );
-    SEXP trial_id = PROTECT( Rf_allocVector( INTSXP, count ) );
-    SEXP trial_onset = PROTECT( Rf_allocVector( REALSXP, count ) );
-    SEXP label = PROTECT( Rf_allocVector( STRSXP, count ) );
-    SEXP label_onset = PROTECT( Rf_allocVector( REALSXP, count ) );
-
-    SET_VECTOR_ELT( df, 0, startscreenx );
-    SET_VECTOR_ELT( df, 1, startscreeny );
-    SET_VECTOR_ELT( df, 2, startx );
-    SET_VECTOR_ELT( df, 3, starty );
-    SET_VECTOR_ELT( df, 4, startz );
-    SET_VECTOR_ELT( df, 5, destscreenx );
-    SET_VECTOR_ELT( df, 6, destscreeny );
-    SET_VECTOR_ELT( df, 7, destx );
-    SET_VECTOR_ELT( df, 8, desty );
-    SET_VECTOR_ELT( df, 9, destz );
-    SET_VECTOR_ELT( df, 10, duration );
-    SET_VECTOR_ELT( df, 11, timestamp );
-    SET_VECTOR_ELT( df, 12, trial_id );
-    SET_VECTOR_ELT( df, 13, trial_onset );
-    SET_VECTOR_ELT( df, 14, label );
-    SET_VECTOR_ELT( df, 15, label_onset );
-
-    UNPROTECT( 16 );
+    CHECK_GAC_HANDLER( ptr );
+#ifndef GAR_STATS
+    error( "parser statistics are disabled, rebuild the package with "
+            "-DGAR_STATS to enable them" );
+#endif
 
-    SET_CLASS( df, mkString( "data.frame" ) );
+    h = R_ExternalPtrAddr( ptr );
 
-    SEXP rownames = PROTECT( allocVector( INTSXP, 2 ) );
-    SET_INTEGER_ELT( rownames, 0, NA_INTEGER );
-    SET_INTEGER_ELT( rownames, 1, -count );
-    setAttrib( df, R_RowNamesSymbol, rownames );
+    ret = PROTECT( Rf_mkNamed( REALSXP, names ) );
+    REAL( ret )[0] = h->stats.samples_in;
+    REAL( ret )[1] = h->stats.samples_added;
+    REAL( ret )[2] = ( double )h->stats.samples_added - h->stats.samples_in;
+    REAL( ret )[3] = h->stats.fixations;
+    REAL( ret )[4] = h->stats.saccades;
+    REAL( ret )[5] = h->stats.analyses;
+    REAL( ret )[6] = h->stats.aoi_tests;
+    REAL( ret )[7] = h->stats.allocs;
+    REAL( ret )[8] = h->stats.time_update;
+    REAL( ret )[9] = h->stats.time_saccade;
+    REAL( ret )[10] = h->stats.time_fixation;
+    REAL( ret )[11] = h->stats.time_aoi;
+    REAL( ret )[12] = h->stats.time_cleanup;
+    REAL( ret )[13] = h->stats.time_frames;
     UNPROTECT( 1 );
 
-    return df;
+    return ret;
 }
 
 /******************************************************************************/
-void gar_saccade_frame_resize( SEXP df, uint32_t new_length )
+SEXP gar_init( void )
 {
-    SETLENGTH( VECTOR_ELT( df, 0 ), new_length );
-    SETLENGTH( VECTOR_ELT( df, 1 ), new_length );
-    SETLENGTH( VECTOR_ELT( df, 2 ), new_length );
-    SETLENGTH( VECTOR_ELT( df, 3 ), new_length );
-    SETLENGTH( VECTOR_ELT( df, 4 ), new_length );
-    SETLENGTH( VECTOR_ELT( df, 5 ), new_length );
-    SETLENGTH( VECTOR_ELT( df, 6 ), new_length );
-    SETLENGTH( VECTOR_ELT( df, 7 ), new_length );
-    SETLENGTH( VECTOR_ELT( df, 8 ), new_length );
-    SETLENGTH( VECTOR_ELT( df, 9 ), new_length );
-    SETLENGTH( VECTOR_ELT( df, 10 ), new_length );
-    SETLENGTH( VECTOR_ELT( df, 11 ), new_length );
-    SETLENGTH( VECTOR_ELT( df, 12 ), new_length );
-    SETLENGTH( VECTOR_ELT( df, 13 ), new_length );
-    SETLENGTH( VECTOR_ELT( df, 14 ), new_length );
-    SETLENGTH( VECTOR_ELT( df, 15 ), new_length );
-
-    SEXP rownames = PROTECT( allocVector( INTSXP, 2 ) );
-    SET_INTEGER_ELT( rownames, 0, NA_INTEGER );
-    SET_INTEGER_ELT( rownames, 1, -new_length );
-    setAttrib( df, R_RowNamesSymbol, rownames );
-    UNPROTECT( 1 );
+    gac_type_tag = install( "GAC_TYPE_TAG" );
+    return R_NilValue;
 }
 
 /******************************************************************************/
-void gar_saccade_frame_unprotect( SEXP df )
+bool gar_label_ids_create( SEXP label, uint32_t offset, uint32_t count,
+        uint32_t* ids, gar_labels_t* labels )
 {
-    UNPROTECT_PTR( df );
-}
+    uint32_t i;
+    SEXP rlabel;
+    SEXP last_rlabel = NULL;
+    uint32_t id = GAR_LABEL_BLANK;
+
+    for( i = 0; i < count; i++ )
+    {
+        rlabel = STRING_ELT( label, offset + i );
+        if( rlabel != last_rlabel )
+        {
+            last_rlabel = rlabel;
+            id = GAR_LABEL_BLANK;
+            if( !Rf_StringBlank( rlabel ) )
+            {
+                id = gar_labels_intern( labels, CHAR( rlabel ) );
+            }
+            if( id == GAR_LABEL_INVALID )
+            {
+                return false;
+            }
+        }
+        ids[i] = id;
+    }
+
+    return true;
+}
+
+/******************************************************************************/
+SEXP gar_label_levels_create( gar_labels_t* labels )
+{
+    uint32_t i;
+    SEXP levels = PROTECT( Rf_allocVector( STRSXP, labels->count ) );
+
+    for( i = 0; i < labels->count; i++ )
+    {
+        SET_STRING_ELT( levels, i, Rf_mkChar( labels->items[i] ) );
+    }
+    UNPROTECT( 1 );
+
+    return levels;
+}
+
+/******************************************************************************/
+void gar_labels_finalise( SEXP ptr )
+{
+    gar_labels_t* labels = R_ExternalPtrAddr( ptr );
+
+    if( labels == NULL )
+    {
+        return;
+    }
+
+    gar_labels_destroy( labels );
+    free( labels );
+    R_ClearExternalPtr( ptr );
+}
+
+/******************************************************************************/
+SEXP gar_flush( SEXP ptr, SEXP factors )
+{
+    SEXP ret;
+    gar_handler_t* h;
+
+    CHECK_GAC_HANDLER( ptr );
+
+    h = R_ExternalPtrAddr( ptr );
+    if( gar_handler_gac( h ) == NULL )
+    {
+        error( "failed to create the gac handler" );
+        return R_NilValue;
+    }
+
+    gar_events_clear( &h->stream );
+    if( !gar_batch_finalise( h->gac, &h->stimuli, &h->stream ) )
+    {
+        error( "failed to allocate memory for the detected events" );
+        return R_NilValue;
+    }
+
+    ret = gar_result_create( &h->stream, h->geometry->aoi_count > 0,
+            Rf_asLogical( factors ) == TRUE );
+    gar_stats_add( &h->stats, &h->stream.stats );
+    gar_events_clear( &h->stream );
+
+    return ret;
+}
+
+/******************************************************************************/
+SEXP gar_parse( SEXP ptr, SEXP px, SEXP py, SEXP pz, SEXP ox, SEXP oy, SEXP oz,
+        SEXP sx, SEXP sy, SEXP timestamp, SEXP trial_id, SEXP label,
+        SEXP factors, SEXP stages )
+{
+    SEXP ret;
+    gar_handler_t* h;
+    uint32_t len;
+    int stage_count;
+    bool res;
+    gar_events_t* events;
+
+    CHECK_GAC_HANDLER( ptr );
+    len = gar_samples_check( px, py, pz, ox, oy, oz, sx, sy, timestamp,
+            trial_id, label );
+    stage_count = Rf_asInteger( stages );
+    if( stage_count == NA_INTEGER || stage_count < 1
+            || stage_count > GAR_PIPELINE_STAGE_COUNT )
+    {
+        error( "the number of stages needs to be between 1 and %d",
+                GAR_PIPELINE_STAGE_COUNT );
+    }
+
+    h = R_ExternalPtrAddr( ptr );
+    events = &h->events;
+
+    // the events of a previous call are left over if it was interrupted
+    gar_events_reset( events );
+    res = gar_samples_parse( h, events, px, py, pz, ox, oy, oz, sx, sy,
+            timestamp, trial_id, label, len, stage_count );
+    if( res )
+    {
+        res = gar_batch_finalise( h->gac, &h->stimuli, events );
+    }
+
+    if( !res )
+    {
+        gar_events_reset( events );
+        error( "failed to allocate memory for the detected events" );
+        return R_NilValue;
+    }
+
+    ret = gar_result_create( events, h->geometry->aoi_count > 0,
+            Rf_asLogical( factors ) == TRUE );
+    gar_stats_add( &h->stats, &events->stats );
+    gar_events_reset( events );
+
+    return ret;
+}
+
+/******************************************************************************/
+SEXP gar_parse_chunk( SEXP ptr, SEXP px, SEXP py, SEXP pz, SEXP ox, SEXP oy,
+        SEXP oz, SEXP sx, SEXP sy, SEXP timestamp, SEXP trial_id, SEXP label,
+        SEXP factors )
+{
+    SEXP ret;
+    gar_handler_t* h;
+    uint32_t len;
+
+    CHECK_GAC_HANDLER( ptr );
+    len = gar_samples_check( px, py, pz, ox, oy, oz, sx, sy, timestamp,
+            trial_id, label );
+
+    h = R_ExternalPtrAddr( ptr );
+
+    gar_events_clear( &h->stream );
+    if( !gar_samples_parse( h, &h->stream, px, py, pz, ox, oy, oz, sx, sy,
+            timestamp, trial_id, label, len, 1 ) )
+    {
+        gar_events_clear( &h->stream );
+        error( "failed to allocate memory for the detected events" );
+        return R_NilValue;
+    }
+
+    ret = gar_result_create( &h->stream, h->geometry->aoi_count > 0,
+            Rf_asLogical( factors ) == TRUE );
+    gar_stats_add( &h->stats, &h->stream.stats );
+    gar_events_clear( &h->stream );
+
+    return ret;
+}
+
+/******************************************************************************/
+SEXP gar_parse_csv( SEXP ptr, SEXP path, SEXP screen, SEXP factors )
+{
+    SEXP ret;
+    gar_handler_t* h;
+    bool res, has_screen;
+    gar_csv_t csv;
+    gar_batch_t batch;
+    gar_batch_buffer_t* buffer;
+    gar_events_t* events;
+    char msg[256];
+
+    CHECK_GAC_HANDLER( ptr );
+    if( !Rf_isString( path ) || Rf_length( path ) != 1
+            || STRING_ELT( path, 0 ) == NA_STRING )
+    {
+        error( "path needs to be a single string" );
+    }
+
+    h = R_ExternalPtrAddr( ptr );
+    if( gar_handler_gac( h ) == NULL )
+    {
+        error( "failed to create the gac handler" );
+        return R_NilValue;
+    }
+    has_screen = Rf_asLogical( screen ) == TRUE;
+
+    if( !gar_csv_open( &csv, CHAR( STRING_ELT( path, 0 ) ), has_screen ) )
+    {
+        snprintf( msg, sizeof( msg ), "failed to read csv file: %s",
+                csv.error );
+        gar_csv_close( &csv );
+        error( "%s", msg );
+        return R_NilValue;
+    }
+
+    buffer = malloc( sizeof( gar_batch_buffer_t ) );
+    if( buffer == NULL )
+    {
+        gar_csv_close( &csv );
+        error( "failed to allocate memory for the detected events" );
+        return R_NilValue;
+    }
+
+    events = &h->events;
+    gar_events_reset( events );
+    gar_batch_buffer_attach( &batch, buffer, has_screen, &events->labels );
+    batch.screen = gar_handler_get_projection( h );
+    do
+    {
+        res = gar_csv_read( &csv, buffer, &events->labels, &batch.count );
+        if( res )
+        {
+            res = gar_batch_parse( h->gac, &h->stimuli, &batch, events );
+            if( !res )
+            {
+                csv.error = "failed to allocate memory for the detected events";
+            }
+        }
+    } while( res && batch.count > 0 );
+
+    if( res )
+    {
+        res = gar_batch_finalise( h->gac, &h->stimuli, events );
+        if( !res )
+        {
+            csv.error = "failed to allocate memory for the detected events";
+        }
+    }
+
+    if( !res )
+    {
+        snprintf( msg, sizeof( msg ), "failed to parse csv file in line %u: %s",
+                csv.line, csv.error );
+        free( buffer );
+        gar_csv_close( &csv );
+        gar_events_reset( events );
+        error( "%s", msg );
+        return R_NilValue;
+    }
+
+    free( buffer );
+    gar_csv_close( &csv );
+    ret = gar_result_create( events, h->geometry->aoi_count > 0,
+            Rf_asLogical( factors ) == TRUE );
+    gar_stats_add( &h->stats, &events->stats );
+    gar_events_reset( events );
+
+    return ret;
+}
+
+/******************************************************************************/
+SEXP gar_parse_grouped( SEXP ptr, SEXP px, SEXP py, SEXP pz, SEXP ox, SEXP oy,
+        SEXP oz, SEXP sx, SEXP sy, SEXP timestamp, SEXP trial_id, SEXP label,
+        SEXP group, SEXP threads, SEXP factors )
+{
+    SEXP ret, levels;
+    gar_handler_t* h;
+    uint32_t len, i, group_count, thread_count;
+    uint32_t *order, *offsets, *cursors, *label_ids;
+    int* group_codes;
+    bool res;
+    gar_group_t groups;
+    gar_events_t events;
+    uint32_t* counts[3];
+
+    CHECK_GAC_HANDLER( ptr );
+    len = gar_samples_check( px, py, pz, ox, oy, oz, sx, sy, timestamp,
+            trial_id, label );
+
+    if( !Rf_isFactor( group ) || ( uint32_t )Rf_length( group ) != len )
+    {
+        error( "group needs to be a factor of the same length as the samples" );
+        return R_NilValue;
+    }
+
+    h = R_ExternalPtrAddr( ptr );
+    levels = Rf_getAttrib( group, R_LevelsSymbol );
+    group_count = Rf_length( levels );
+    group_codes = INTEGER( group );
+
+    // partition the samples by group, keeping the input order within a group
+    offsets = ( uint32_t* )R_alloc( group_count + 1, sizeof( uint32_t ) );
+    cursors = ( uint32_t* )R_alloc( group_count + 1, sizeof( uint32_t ) );
+    order = ( uint32_t* )R_alloc( len > 0 ? len : 1, sizeof( uint32_t ) );
+    memset( offsets, 0, ( group_count + 1 ) * sizeof( uint32_t ) );
+    for( i = 0; i < len; i++ )
+    {
+        if( group_codes[i] != NA_INTEGER )
+        {
+            // factor codes start at 1
+            offsets[group_codes[i]]++;
+        }
+    }
+    for( i = 0; i < group_count; i++ )
+    {
+        offsets[i + 1] += offsets[i];
+    }
+    memcpy( cursors, offsets, ( group_count + 1 ) * sizeof( uint32_t ) );
+    for( i = 0; i < len; i++ )
+    {
+        if( group_codes[i] != NA_INTEGER )
+        {
+            order[cursors[group_codes[i] - 1]++] = i;
+        }
+    }
+
+    // all R API calls are done here, before the worker threads are started;
+    // R_alloc may longjmp, so it runs before the event lists are allocated
+    label_ids = ( uint32_t* )R_alloc( len > 0 ? len : 1, sizeof( uint32_t ) );
+    counts[0] = ( uint32_t* )R_alloc( group_count + 1, sizeof( uint32_t ) );
+    counts[1] = ( uint32_t* )R_alloc( group_count + 1, sizeof( uint32_t ) );
+    counts[2] = ( uint32_t* )R_alloc( group_count + 1, sizeof( uint32_t ) );
+    thread_count = gar_thread_count( Rf_asInteger( threads ), group_count );
+
+    if( !gar_events_init( &events, NULL ) )
+    {
+        error( "failed to allocate memory for the detected events" );
+        return R_NilValue;
+    }
+    if( !gar_label_ids_create( label, 0, len, label_ids, &events.labels ) )
+    {
+        gar_events_destroy( &events );
+        error( "failed to allocate memory for the sample labels" );
+        return R_NilValue;
+    }
+
+    groups.h = h;
+    gar_samples_attach( &groups.samples, px, py, pz, ox, oy, oz, sx, sy,
+            timestamp, trial_id );
+    groups.samples.label = label_ids;
+    groups.samples.labels = &events.labels;
+    groups.samples.screen = gar_handler_get_projection( h );
+    groups.samples.count = len;
+    groups.order = order;
+    groups.offsets = offsets;
+    groups.group_count = group_count;
+    groups.events = calloc( group_count > 0 ? group_count : 1,
+            sizeof( gar_events_t ) );
+
+    res = groups.events != NULL;
+    if( res )
+    {
+        res = gar_group_parse( &groups, thread_count );
+    }
+
+    // concatenate the group results in group order
+    for( i = 0; res && i < group_count; i++ )
+    {
+        res = gar_events_append( &events, &groups.events[i] );
+        counts[0][i] = groups.events[i].fixation_count;
+        counts[1][i] = groups.events[i].saccade_count;
+        counts[2][i] = groups.events[i].analysis_count;
+    }
+
+    if( groups.events != NULL )
+    {
+        for( i = 0; i < group_count; i++ )
+        {
+            gar_events_destroy( &groups.events[i] );
+        }
+        free( groups.events );
+    }
+
+    if( !res )
+    {
+        gar_events_destroy( &events );
+        error( "failed to parse the sample groups" );
+        return R_NilValue;
+    }
+
+    ret = PROTECT( gar_result_create( &events, h->geometry->aoi_count > 0,
+                Rf_asLogical( factors ) == TRUE ) );
+    gar_stats_add( &h->stats, &events.stats );
+    gar_events_destroy( &events );
+
+    for( i = 0; i < 3; i++ )
+    {
+        if( VECTOR_ELT( ret, i ) != R_NilValue )
+        {
+            SET_VECTOR_ELT( ret, i, gar_frame_group_add( VECTOR_ELT( ret, i ),
+                        counts[i], group_count, levels ) );
+        }
+    }
+    UNPROTECT( 1 );
+
+    return ret;
+}
+
+/******************************************************************************/
+SEXP gar_parse_sweep( SEXP ptr, SEXP px, SEXP py, SEXP pz, SEXP ox, SEXP oy,
+        SEXP oz, SEXP sx, SEXP sy, SEXP timestamp, SEXP trial_id, SEXP label,
+        SEXP velocity_threshold, SEXP duration_threshold,
+        SEXP dispersion_threshold, SEXP threads )
+{
+    SEXP df, rownames;
+    gar_handler_t* h;
+    uint32_t len, i, k, config_count, thread_count;
+    uint32_t* label_ids;
+    bool res;
+    gar_labels_t labels;
+    gar_sweep_t sweep;
+    gar_sweep_result_t* result;
+    SEXP thresholds[3] = { velocity_threshold, duration_threshold,
+        dispersion_threshold };
+    const char* names[] = { "fixations", "saccades", "aoi",
+        "fixation_duration_mean", "saccade_duration_mean", "" };
+
+    CHECK_GAC_HANDLER( ptr );
+    len = gar_samples_check( px, py, pz, ox, oy, oz, sx, sy, timestamp,
+            trial_id, label );
+
+    config_count = 0;
+    for( k = 0; k < 3; k++ )
+    {
+        if( thresholds[k] == R_NilValue )
+        {
+            continue;
+        }
+        if( !Rf_isReal( thresholds[k] ) || ( config_count > 0
+                    && ( uint32_t )Rf_length( thresholds[k] ) != config_count ) )
+        {
+            error( "all thresholds need to be double vectors of the same length" );
+            return R_NilValue;
+        }
+        config_count = Rf_length( thresholds[k] );
+    }
+
+    h = R_ExternalPtrAddr( ptr );
+
+    sweep.h = h;
+    sweep.config_count = config_count;
+    sweep.params = ( gac_filter_parameter_t* )R_alloc(
+            config_count > 0 ? config_count : 1,
+            sizeof( gac_filter_parameter_t ) );
+    sweep.results = ( gar_sweep_result_t* )R_alloc(
+            config_count > 0 ? config_count : 1, sizeof( gar_sweep_result_t ) );
+    for( i = 0; i < config_count; i++ )
+    {
+        sweep.params[i] = h->params;
+        if( velocity_threshold != R_NilValue )
+        {
+            sweep.params[i].saccade.velocity_threshold =
+                REAL( velocity_threshold )[i];
+        }
+        if( duration_threshold != R_NilValue )
+        {
+            sweep.params[i].fixation.duration_threshold =
+                REAL( duration_threshold )[i];
+        }
+        if( dispersion_threshold != R_NilValue )
+        {
+            sweep.params[i].fixation.dispersion_threshold =
+                REAL( dispersion_threshold )[i];
+        }
+    }
+
+    // all R API calls are done here, before the worker threads are started;
+    // R_alloc may longjmp, so it runs before the label dictionary is allocated
+    label_ids = ( uint32_t* )R_alloc( len > 0 ? len : 1, sizeof( uint32_t ) );
+    thread_count = gar_thread_count( Rf_asInteger( threads ), config_count );
+    if( !gar_labels_init( &labels, NULL ) )
+    {
+        error( "failed to allocate memory for the sample labels" );
+        return R_NilValue;
+    }
+    if( !gar_label_ids_create( label, 0, len, label_ids, &labels ) )
+    {
+        gar_labels_destroy( &labels );
+        error( "failed to allocate memory for the sample labels" );
+        return R_NilValue;
+    }
+
+    gar_samples_attach( &sweep.samples, px, py, pz, ox, oy, oz, sx, sy,
+            timestamp, trial_id );
+    sweep.samples.label = label_ids;
+    sweep.samples.labels = &labels;
+    sweep.samples.screen = gar_handler_get_projection( h );
+    sweep.samples.count = len;
+
+    res = gar_sweep_parse( &sweep, thread_count );
+    gar_labels_destroy( &labels );
+
+    if( !res )
+    {
+        error( "failed to parse the filter configurations" );
+        return R_NilValue;
+    }
+
+    df = PROTECT( Rf_mkNamed( VECSXP, names ) );
+    SET_VECTOR_ELT( df, 0, Rf_allocVector( INTSXP, config_count ) );
+    SET_VECTOR_ELT( df, 1, Rf_allocVector( INTSXP, config_count ) );
+    SET_VECTOR_ELT( df, 2, Rf_allocVector( INTSXP, config_count ) );
+    SET_VECTOR_ELT( df, 3, Rf_allocVector( REALSXP, config_count ) );
+    SET_VECTOR_ELT( df, 4, Rf_allocVector( REALSXP, config_count ) );
+    for( i = 0; i < config_count; i++ )
+    {
+        result = &sweep.results[i];
+        INTEGER( VECTOR_ELT( df, 0 ) )[i] = result->fixation_count;
+        INTEGER( VECTOR_ELT( df, 1 ) )[i] = result->saccade_count;
+        INTEGER( VECTOR_ELT( df, 2 ) )[i] = result->analysis_count;
+        REAL( VECTOR_ELT( df, 3 ) )[i] = ( result->fixation_count > 0 )
+            ? result->fixation_duration / result->fixation_count : NA_REAL;
+        REAL( VECTOR_ELT( df, 4 ) )[i] = ( result->saccade_count > 0 )
+            ? result->saccade_duration / result->saccade_count : NA_REAL;
+        gar_stats_add( &h->stats, &result->stats );
+    }
+    SET_CLASS( df, mkString( "data.frame" ) );
+
+    rownames = PROTECT( allocVector( INTSXP, 2 ) );
+    SET_INTEGER_ELT( rownames, 0, NA_INTEGER );
+    SET_INTEGER_ELT( rownames, 1, -config_count );
+    setAttrib( df, R_RowNamesSymbol, rownames );
+    UNPROTECT( 2 );
+
+    return df;
+}
+
+/******************************************************************************/
+SEXP gar_parse_trials( SEXP ptr, SEXP px, SEXP py, SEXP pz, SEXP ox, SEXP oy,
+        SEXP oz, SEXP sx, SEXP sy, SEXP timestamp, SEXP trial_id, SEXP label,
+        SEXP threads, SEXP margin, SEXP factors )
+{
+    SEXP ret;
+    gar_handler_t* h;
+    uint32_t len, i, thread_count;
+    uint32_t* label_ids;
+    bool res;
+    gar_trials_t trials;
+    gar_events_t events;
+
+    CHECK_GAC_HANDLER( ptr );
+    len = gar_samples_check( px, py, pz, ox, oy, oz, sx, sy, timestamp,
+            trial_id, label );
+
+    trials.margin = Rf_asReal( margin );
+    if( ISNAN( trials.margin ) || trials.margin < 0 )
+    {
+        error( "the margin needs to be a positive number" );
+        return R_NilValue;
+    }
+
+    h = R_ExternalPtrAddr( ptr );
+
+    // all R API calls are done here, before the worker threads are started;
+    // R_alloc may longjmp, so it runs before the event list is allocated
+    label_ids = ( uint32_t* )R_alloc( len > 0 ? len : 1, sizeof( uint32_t ) );
+
+    // split into more blocks than threads to balance uneven trials
+    thread_count = gar_thread_count( Rf_asInteger( threads ),
+            len > 0 ? len : 1 );
+    trials.offsets = ( uint32_t* )R_alloc(
+            thread_count * GAR_TRIALS_BLOCKS_PER_THREAD + 1,
+            sizeof( uint32_t ) );
+
+    if( !gar_events_init( &events, NULL ) )
+    {
+        error( "failed to allocate memory for the detected events" );
+        return R_NilValue;
+    }
+    if( !gar_label_ids_create( label, 0, len, label_ids, &events.labels ) )
+    {
+        gar_events_destroy( &events );
+        error( "failed to allocate memory for the sample labels" );
+        return R_NilValue;
+    }
+
+    trials.h = h;
+    gar_samples_attach( &trials.samples, px, py, pz, ox, oy, oz, sx, sy,
+            timestamp, trial_id );
+    trials.samples.label = label_ids;
+    trials.samples.labels = &events.labels;
+    trials.samples.screen = gar_handler_get_projection( h );
+    trials.samples.count = len;
+    gar_trials_split( &trials, thread_count * GAR_TRIALS_BLOCKS_PER_THREAD );
+    trials.events = calloc( trials.block_count > 0 ? trials.block_count : 1,
+            sizeof( gar_events_t ) );
+
+    res = trials.events != NULL;
+    if( res )
+    {
+        res = gar_trials_parse( &trials, gar_thread_count(
+                    Rf_asInteger( threads ), trials.block_count ) );
+    }
+
+    // stitch the block results in block order which is the timestamp order
+    for( i = 0; res && i < trials.block_count; i++ )
+    {
+        res = gar_events_append( &events, &trials.events[i] );
+    }
+
+    if( trials.events != NULL )
+    {
+        for( i = 0; i < trials.block_count; i++ )
+        {
+            gar_events_destroy( &trials.events[i] );
+        }
+        free( trials.events );
+    }
+
+    if( !res )
+    {
+        gar_events_destroy( &events );
+        error( "failed to parse the trial blocks" );
+        return R_NilValue;
+    }
+
+    ret = gar_result_create( &events, h->geometry->aoi_count > 0,
+            Rf_asLogical( factors ) == TRUE );
+    gar_stats_add( &h->stats, &events.stats );
+    gar_events_destroy( &events );
+
+    return ret;
+}
+
+/******************************************************************************/
+SEXP gar_poll( SEXP ptr, SEXP flush, SEXP factors )
+{
+    SEXP ret;
+    gar_handler_t* h;
+
+    CHECK_GAC_HANDLER( ptr );
+
+    h = R_ExternalPtrAddr( ptr );
+    if( gar_handler_gac( h ) == NULL )
+    {
+        error( "failed to create the gac handler" );
+        return R_NilValue;
+    }
+
+    if( Rf_asLogical( flush ) == TRUE
+            && !gar_online_finalise( &h->online, h->gac,
+                    &h->stimuli, gar_stats_now() ) )
+    {
+        error( "failed to allocate memory for the detected events" );
+        return R_NilValue;
+    }
+
+    ret = gar_result_create( &h->online.events,
+            h->geometry->aoi_count > 0, Rf_asLogical( factors ) == TRUE );
+    gar_stats_add( &h->stats, &h->online.events.stats );
+    gar_online_clear( &h->online );
+
+    return ret;
+}
+
+/******************************************************************************/
+SEXP gar_project_screen( SEXP ptr, SEXP px, SEXP py, SEXP pz, SEXP ox,
+        SEXP oy, SEXP oz )
+{
+    SEXP df, sx, sy, rownames;
+    gar_handler_t* h;
+    int32_t len;
+    gar_batch_t batch;
+    const char* names[] = { "sx", "sy", "" };
+
+    CHECK_GAC_HANDLER( ptr );
+    if( !Rf_isReal( px ) || !Rf_isReal( py ) || !Rf_isReal( pz )
+            || !Rf_isReal( ox ) || !Rf_isReal( oy ) || !Rf_isReal( oz ) )
+    {
+        error( "all point vectors need to be of type double" );
+    }
+    len = Rf_length( px );
+    if( Rf_length( py ) != len || Rf_length( pz ) != len
+            || Rf_length( ox ) != len || Rf_length( oy ) != len
+            || Rf_length( oz ) != len )
+    {
+        error( "all vectors need to be of the same length" );
+    }
+
+    h = R_ExternalPtrAddr( ptr );
+    if( gar_handler_get_projection( h ) == NULL )
+    {
+        error( "the screen is not configured, use gar_set_screen() first" );
+    }
+
+    df = PROTECT( Rf_mkNamed( VECSXP, names ) );
+    sx = Rf_allocVector( REALSXP, len );
+    SET_VECTOR_ELT( df, 0, sx );
+    sy = Rf_allocVector( REALSXP, len );
+    SET_VECTOR_ELT( df, 1, sy );
+
+    batch.px = REAL( px );
+    batch.py = REAL( py );
+    batch.pz = REAL( pz );
+    batch.ox = REAL( ox );
+    batch.oy = REAL( oy );
+    batch.oz = REAL( oz );
+    batch.screen = gar_handler_get_projection( h );
+    batch.count = len;
+    gar_batch_project( &batch, REAL( sx ), REAL( sy ) );
+
+    SET_CLASS( df, mkString( "data.frame" ) );
+    rownames = PROTECT( allocVector( INTSXP, 2 ) );
+    SET_INTEGER_ELT( rownames, 0, NA_INTEGER );
+    SET_INTEGER_ELT( rownames, 1, -len );
+    setAttrib( df, R_RowNamesSymbol, rownames );
+    UNPROTECT( 2 );
+
+    return df;
+}
+
+/******************************************************************************/
+SEXP gar_push( SEXP ptr, SEXP px, SEXP py, SEXP pz, SEXP ox, SEXP oy,
+        SEXP oz, SEXP sx, SEXP sy, SEXP timestamp, SEXP trial_id, SEXP label )
+{
+    uint32_t label_ids[GAR_BATCH_SIZE];
+    uint32_t len, i, j;
+    bool res, has_screen;
+    gar_handler_t* h;
+    gar_batch_t samples;
+    gar_batch_t batch;
+    gar_sample_t* packed;
+    gar_labels_t* labels;
+    double arrival = gar_stats_now();
+
+    CHECK_GAC_HANDLER( ptr );
+    len = gar_samples_check( px, py, pz, ox, oy, oz, sx, sy, timestamp,
+            trial_id, label );
+
+    h = R_ExternalPtrAddr( ptr );
+    if( gar_handler_gac( h ) == NULL )
+    {
+        error( "failed to create the gac handler" );
+        return R_NilValue;
+    }
+    labels = &h->online.events.labels;
+    packed = ( gar_sample_t* )R_alloc( GAR_BATCH_SIZE,
+            sizeof( gar_sample_t ) );
+
+    gar_samples_attach( &samples, px, py, pz, ox, oy, oz, sx, sy, timestamp,
+            trial_id );
+    samples.labels = labels;
+    samples.screen = gar_handler_get_projection( h );
+    samples.count = len;
+    has_screen = ( samples.sx != NULL && samples.sy != NULL )
+        || samples.screen != NULL;
+
+    res = true;
+    for( i = 0; res && i < len; i += batch.count )
+    {
+        gar_batch_slice( &batch, &samples, i, GAR_BATCH_SIZE );
+        batch.label = label_ids;
+        res = gar_label_ids_create( label, i, batch.count, label_ids, labels );
+        if( !res )
+        {
+            break;
+        }
+        gar_batch_pack( &batch, packed );
+        for( j = 0; res && j < batch.count; j++ )
+        {
+            res = gar_online_push( &h->online, h->gac, &h->stimuli,
+                    &packed[j], has_screen, arrival );
+        }
+    }
+
+    if( !res )
+    {
+        error( "failed to allocate memory for the detected events" );
+        return R_NilValue;
+    }
+
+    return R_NilValue;
+}
+
+/******************************************************************************/
+SEXP gar_reset_stats( SEXP ptr )
+{
+    gar_handler_t* h;
+
+    CHECK_GAC_HANDLER( ptr );
+
+    h = R_ExternalPtrAddr( ptr );
+    memset( &h->stats, 0, sizeof( gar_stats_t ) );
+
+    return R_NilValue;
+}
+
+/******************************************************************************/
+SEXP gar_result_create( gar_events_t* events, bool has_aoi, bool factor )
+{
+    SEXP ret, fixations, saccades, aoi, levels;
+    const char* names[] = { "fixations", "saccades", "aoi", "" };
+    GAR_STATS_DECLARE( t );
+
+    GAR_STATS_START( t );
+    ret = PROTECT( Rf_mkNamed( VECSXP, names ) );
+    levels = PROTECT( gar_label_levels_create( &events->labels ) );
+
+    fixations = gar_frame_fixations_create( events, levels, factor );
+    SET_VECTOR_ELT( ret, 0, fixations );
+
+    saccades = gar_frame_saccades_create( events, levels, factor );
+    SET_VECTOR_ELT( ret, 1, saccades );
+    UNPROTECT( 1 );
+
+    if( has_aoi )
+    {
+        levels = PROTECT( gar_label_levels_create( &events->aoi_names ) );
+        aoi = gar_frame_analyses_create( events, levels, factor );
+        SET_VECTOR_ELT( ret, 2, aoi );
+        UNPROTECT( 1 );
+    }
+
+    UNPROTECT( 1 );
+    GAR_STATS_STOP( &events->stats, time_frames, t );
+
+    return ret;
+}
 
 /******************************************************************************/
-void gar_saccade_frame_update( SEXP df, uint32_t idx, gac_saccade_t* saccade )
+void gar_samples_attach( gar_batch_t* batch, SEXP px, SEXP py, SEXP pz,
+        SEXP ox, SEXP oy, SEXP oz, SEXP sx, SEXP sy, SEXP timestamp,
+        SEXP trial_id )
 {
-    const char* label = saccade->first_sample.label;
+    batch->px = REAL( px );
+    batch->py = REAL( py );
+    batch->pz = REAL( pz );
+    batch->ox = REAL( ox );
+    batch->oy = REAL( oy );
+    batch->oz = REAL( oz );
+    batch->sx = ( sx != R_NilValue ) ? REAL( sx ) : NULL;
+    batch->sy = ( sy != R_NilValue ) ? REAL( sy ) : NULL;
+    batch->timestamp = REAL( timestamp );
+    batch->trial_id = INTEGER( trial_id );
+    batch->label = NULL;
+    batch->labels = NULL;
+    batch->screen = NULL;
+    batch->count = 0;
+}
+
+/******************************************************************************/
+uint32_t gar_samples_check( SEXP px, SEXP py, SEXP pz, SEXP ox, SEXP oy,
+        SEXP oz, SEXP sx, SEXP sy, SEXP timestamp, SEXP trial_id, SEXP label )
+{
+    int32_t len;
 
-    REAL( VECTOR_ELT( df, 0 ) )[idx] = saccade->first_sample.screen_point[0];
-    REAL( VECTOR_ELT( df, 1 ) )[idx] = saccade->first_sample.screen_point[1];
-    REAL( VECTOR_ELT( df, 2 ) )[idx] = saccade->first_sample.point[0];
-    REAL( VECTOR_ELT( df, 3 ) )[idx] = saccade->first_sample.point[1];
-    REAL( VECTOR_ELT( df, 4 ) )[idx] = saccade->first_sample.point[2];
-    REAL( VECTOR_ELT( df, 5 ) )[idx] = saccade->last_sample.screen_point[0];
-    REAL( VECTOR_ELT( df, 6 ) )[idx] = saccade->last_sample.screen_point[1];
-    REAL( VECTOR_ELT( df, 7 ) )[idx] = saccade->last_sample.point[0];
-    REAL( VECTOR_ELT( df, 8 ) )[idx] = saccade->last_sample.point[1];
-    REAL( VECTOR_ELT( df, 9 ) )[idx] = saccade->last_sample.point[2];
-    REAL( VECTOR_ELT( df, 10 ) )[idx] =
-        saccade->last_sample.timestamp - saccade->first_sample.timestamp;
-    REAL( VECTOR_ELT( df, 11 ) )[idx] = saccade->first_sample.timestamp;
-    INTEGER( VECTOR_ELT( df, 12 ) )[idx] = saccade->first_sample.trial_id;
-    REAL( VECTOR_ELT( df, 13 ) )[idx] = saccade->first_sample.trial_onset;
-    SET_STRING_ELT( VECTOR_ELT( df, 14 ), idx, Rf_mkChar( label ) );
-    REAL( VECTOR_ELT( df, 15 ) )[idx] = saccade->first_sample.label_onset;
+    if( !Rf_isReal( px )
+        || !Rf_isReal( py )
+        || !Rf_isReal( pz )
+        || ( sx != R_NilValue && !Rf_isReal( sx ) )
+        || ( sy != R_NilValue && !Rf_isReal( sy ) )
+        || !Rf_isReal( ox )
+        || !Rf_isReal( oy )
+        || !Rf_isReal( oz )
+        || !Rf_isReal( timestamp ) )
+    {
+        error( "all point and timestamp vectors need to be of type double" );
+    }
+
+    if( !Rf_isInteger( trial_id ) )
+    {
+        error( "trial ID vector needs to be of type integer" );
+    }
+
+    if( !Rf_isString( label ) )
+    {
+        error( "label vector needs to be of type string" );
+    }
+
+    len = Rf_length( timestamp );
+
+    if( Rf_length( px ) != len
+        || Rf_length( py ) != len
+        || Rf_length( pz ) != len
+        || ( sx != R_NilValue && Rf_length( sx ) != len )
+        || ( sy != R_NilValue && Rf_length( sy ) != len )
+        || Rf_length( ox ) != len
+        || Rf_length( oy ) != len
+        || Rf_length( oz ) != len
+        || Rf_length( trial_id ) != len
+        || Rf_length( label ) != len )
+    {
+        error( "all vectors need to be of the same length" );
+    }
+
+    return len;
+}
+
+/******************************************************************************/
+bool gar_samples_ingest( void* data, uint32_t offset, uint32_t count,
+        uint32_t* ids, gar_labels_t* labels )
+{
+    return gar_label_ids_create( ( SEXP )data, offset, count, ids, labels );
+}
+
+/******************************************************************************/
+bool gar_samples_parse( gar_handler_t* h, gar_events_t* events, SEXP px,
+        SEXP py, SEXP pz, SEXP ox, SEXP oy, SEXP oz, SEXP sx, SEXP sy,
+        SEXP timestamp, SEXP trial_id, SEXP label, uint32_t len,
+        uint32_t stage_count )
+{
+    gar_batch_t samples;
+
+    if( gar_handler_gac( h ) == NULL )
+    {
+        return false;
+    }
+
+    gar_samples_attach( &samples, px, py, pz, ox, oy, oz, sx, sy, timestamp,
+            trial_id );
+    samples.label = NULL;
+    samples.labels = &events->labels;
+    samples.screen = gar_handler_get_projection( h );
+    samples.count = len;
+
+    return gar_pipeline_parse( h->gac, &h->stimuli, &samples, events,
+            stage_count, gar_samples_ingest, label );
+}
+
+/******************************************************************************/
+SEXP gar_set_screen( SEXP ptr,
+        SEXP top_left_x, SEXP top_left_y, SEXP top_left_z,
+        SEXP top_right_x, SEXP top_right_y, SEXP top_right_z,
+        SEXP bottom_left_x, SEXP bottom_left_y, SEXP bottom_left_z,
+        SEXP project )
+{
+    gar_handler_t* h = R_ExternalPtrAddr( ptr );
+    double screen[9];
+
+    screen[0] = Rf_asReal( top_left_x );
+    screen[1] = Rf_asReal( top_left_y );
+    screen[2] = Rf_asReal( top_left_z );
+    screen[3] = Rf_asReal( top_right_x );
+    screen[4] = Rf_asReal( top_right_y );
+    screen[5] = Rf_asReal( top_right_z );
+    screen[6] = Rf_asReal( bottom_left_x );
+    screen[7] = Rf_asReal( bottom_left_y );
+    screen[8] = Rf_asReal( bottom_left_z );
+    if( !gar_handler_set_screen( h, screen, Rf_asLogical( project ) ) )
+    {
+        error( "failed to set the screen" );
+        return R_NilValue;
+    }
+
+    return R_NilValue;
+}
+
+/******************************************************************************/
+void gar_synth_parameter_parse( gar_synth_parameter_t* params, SEXP rate,
+        SEXP gap_rate, SEXP nan_rate, SEXP trial_duration,
+        SEXP label_duration, SEXP seed )
+{
+    gar_synth_parameter_default( params, Rf_asReal( rate ) );
+    params->gap_rate = Rf_asReal( gap_rate );
+    params->nan_rate = Rf_asReal( nan_rate );
+    params->trial_duration = Rf_asReal( trial_duration );
+    params->label_duration = Rf_asReal( label_duration );
+    params->seed = ( uint64_t )Rf_asReal( seed );
+
+    if( ISNAN( params->rate ) || params->rate <= 0 )
+    {
+        error( "the sample rate needs to be a positive number" );
+    }
+}
+
+/******************************************************************************/
+SEXP gar_synthesise( SEXP n, SEXP rate, SEXP gap_rate, SEXP nan_rate,
+        SEXP trial_duration, SEXP label_duration, SEXP seed )
+{
+    SEXP df, levels, rownames, label, ptr;
+    SEXP columns[10];
+    uint32_t i, j, k, len, count;
+    gar_synth_t synth;
+    gar_synth_parameter_t params;
+    gar_batch_buffer_t* buffer;
+    gar_labels_t* labels;
+    double* src[9];
+    const char* names[] = { "sx", "sy", "px", "py", "pz", "ox", "oy", "oz",
+        "timestamp", "trial_id", "label", "" };
+
+    if( ISNAN( Rf_asReal( n ) ) || Rf_asReal( n ) < 0
+            || Rf_asReal( n ) >= INT32_MAX )
+    {
+        error( "the sample count needs to be a non-negative number" );
+    }
+    len = Rf_asReal( n );
+    gar_synth_parameter_parse( &params, rate, gap_rate, nan_rate,
+            trial_duration, label_duration, seed );
+
+    // the R objects are allocated first; the only heap allocation, the label
+    // dictionary, is held by an external pointer such that it is released
+    // by its finaliser if an R API call fails
+    buffer = ( gar_batch_buffer_t* )R_alloc( 1, sizeof( gar_batch_buffer_t ) );
+    df = PROTECT( Rf_mkNamed( VECSXP, names ) );
+    for( j = 0; j < 9; j++ )
+    {
+        SET_VECTOR_ELT( df, j, Rf_allocVector( REALSXP, len ) );
+        columns[j] = VECTOR_ELT( df, j );
+    }
+    SET_VECTOR_ELT( df, 9, Rf_allocVector( INTSXP, len ) );
+    columns[9] = VECTOR_ELT( df, 9 );
+    SET_VECTOR_ELT( df, 10, Rf_allocVector( STRSXP, len ) );
+    label = VECTOR_ELT( df, 10 );
+    rownames = PROTECT( allocVector( INTSXP, 2 ) );
+    ptr = PROTECT( R_MakeExternalPtr( NULL, R_NilValue, R_NilValue ) );
+    R_RegisterCFinalizerEx( ptr, gar_labels_finalise, TRUE );
+
+    labels = malloc( sizeof( gar_labels_t ) );
+    if( labels == NULL )
+    {
+        error( "failed to allocate memory for the samples" );
+    }
+    if( !gar_labels_init( labels, NULL ) )
+    {
+        free( labels );
+        error( "failed to allocate memory for the samples" );
+    }
+    R_SetExternalPtrAddr( ptr, labels );
+    if( !gar_synth_init( &synth, &params, labels ) )
+    {
+        error( "failed to allocate memory for the samples" );
+    }
+    levels = PROTECT( gar_label_levels_create( labels ) );
+
+    src[0] = buffer->sx;
+    src[1] = buffer->sy;
+    src[2] = buffer->px;
+    src[3] = buffer->py;
+    src[4] = buffer->pz;
+    src[5] = buffer->ox;
+    src[6] = buffer->oy;
+    src[7] = buffer->oz;
+    src[8] = buffer->timestamp;
+
+    for( i = 0; i < len; i += count )
+    {
+        count = ( len - i < GAR_BATCH_SIZE ) ? len - i : GAR_BATCH_SIZE;
+        gar_synth_fill( &synth, buffer, count );
+        for( j = 0; j < 9; j++ )
+        {
+            memcpy( &REAL( columns[j] )[i], src[j], count * sizeof( double ) );
+        }
+        memcpy( &INTEGER( columns[9] )[i], buffer->trial_id,
+                count * sizeof( int ) );
+        for( k = 0; k < count; k++ )
+        {
+            SET_STRING_ELT( label, i + k,
+                    STRING_ELT( levels, buffer->label[k] ) );
+        }
+    }
+
+    gar_labels_finalise( ptr );
+
+    SET_CLASS( df, mkString( "data.frame" ) );
+
+    SET_INTEGER_ELT( rownames, 0, NA_INTEGER );
+    SET_INTEGER_ELT( rownames, 1, -len );
+    setAttrib( df, R_RowNamesSymbol, rownames );
+    UNPROTECT( 4 );
+
+    return df;
 }
 
 /******************************************************************************/
 SEXP gar_destroy( SEXP ptr )
 {
-    void* h;
+    gar_handler_t* h;
 
     CHECK_GAC_HANDLER( ptr );
 
     h = R_ExternalPtrAddr( ptr );
-    gac_destroy( h );
+    gar_handler_destroy( h );
 
     return R_NilValue;
 }
@@ -7,6 +7,9 @@
 #include <Rinternals.h>
 #include "gac.h"
 #include "gac_aoi_collection.h"
+#include "gar_batch.h"
+#include "gar_handler.h"
+#include "gar_synth.h"
 
 /**
  * Add an AOI defined by points to the gaze anlysis structure. This enables the
@@ -18,10 +21,13 @@
  *  A data frame where each row is a normalized 2d point of the AOI.
  * @param label
  *  An optional label describing the AOI.
+ * @param stimulus
+ *  An optional stimulus. The AOI is only analysed on fixations where the
+ *  sample label matches the stimulus.
  * @return
  *  R_NilValue
  */
-SEXP gar_add_aoi_points( SEXP ptr, SEXP points, SEXP label );
+SEXP gar_add_aoi_points( SEXP ptr, SEXP points, SEXP label, SEXP stimulus );
 
 /**
  * Add an AOI rectangle to the gaze anlysis structure. This enables the AOI
@@ -39,53 +45,85 @@ SEXP gar_add_aoi_points( SEXP ptr, SEXP points, SEXP label );
  *  The normalized height of the AOI.
  * @param label
  *  An optional label describing the AOI.
+ * @param stimulus
+ *  An optional stimulus. The AOI is only analysed on fixations where the
+ *  sample label matches the stimulus.
  * @return
  *  R_NilValue
  */
 SEXP gar_add_aoi_rectangle( SEXP ptr, SEXP x, SEXP y, SEXP width, SEXP height,
-        SEXP label );
+        SEXP label, SEXP stimulus );
 
 /**
- * Create a data frame container to hold fixations.
+ * Add a list of AOIs defined by points to the gaze analysis structure at
+ * once. The points of all AOIs are collected into one point buffer in a
+ * single pass. Either all AOIs are added or none.
  *
- * @param count
- *  A preliminary count of items to be added to the data frame.
+ * @param ptr
+ *  An external pointer structure pointing to the gac handler.
+ * @param aoi_id
+ *  The 1-based index of the AOI of each point.
+ * @param x
+ *  The normalized x coordinates of the AOI points.
+ * @param y
+ *  The normalized y coordinates of the AOI points.
+ * @param label
+ *  An optional character vector holding the label of each AOI.
+ * @param stimulus
+ *  An optional character vector holding the stimulus of each AOI.
+ * @param aoi_count
+ *  The number of AOIs.
  * @return
- *  The data frame.
- */
-SEXP gar_analysis_frame_create( uint32_t count );
-
-/**
- * Resize the AOI analysis data frame.
- *
- * @param df
- *  The data frame to rezise.
- * @param new_length
- *  The ne length of the data frame
+ *  R_NilValue
  */
-void gar_analysis_frame_resize( SEXP df, uint32_t new_length );
+SEXP gar_add_aois( SEXP ptr, SEXP aoi_id, SEXP x, SEXP y, SEXP label,
+        SEXP stimulus, SEXP aoi_count );
 
 /**
- * Release the protection of the AOI analysis data frame.
+ * Parse a synthetic gaze stream and measure the throughput. The samples are
+ * generated block-wise and passed to a new gac handler which is configured
+ * like the gac handler of `ptr`. Only the number of detected events is kept
+ * such that the memory consumption does not depend on the sample count. The
+ * parser statistics are added to the statistics of `ptr`.
  *
- * @param df
- *  The data frame to unprotect.
+ * @param ptr
+ *  An external pointer structure pointing to the gac handler.
+ * @param n
+ *  The number of samples to generate.
+ * @param rate
+ *  The sample rate in Hz.
+ * @param gap_rate
+ *  The probability of a gap (blink or tracking loss) after a fixation.
+ * @param nan_rate
+ *  The fraction of samples where all coordinates are NaN.
+ * @param trial_duration
+ *  The duration of a trial in milliseconds.
+ * @param label_duration
+ *  The duration of a label in milliseconds.
+ * @param seed
+ *  The seed of the random number generator.
+ * @return
+ *  A named numeric vector holding the sample and event counts, the elapsed
+ *  time in seconds, the throughput, the peak resident set size in KB, and
+ *  the number of heap allocations while parsing (NA if the package was not
+ *  built with GAR_STATS).
  */
-void gar_analysis_frame_unprotect( SEXP df );
+SEXP gar_benchmark( SEXP ptr, SEXP n, SEXP rate, SEXP gap_rate,
+        SEXP nan_rate, SEXP trial_duration, SEXP label_duration, SEXP seed );
 
 /**
- * Add a new entry to the AOI analysis data frame.
+ * Allocate a new gac handler which shares the configuration of another
+ * handler. The screen and AOI configuration is shared between both handlers
+ * until one of them is reconfigured. The stream state of the handler is not
+ * copied (see gar_handler_clone()).
  *
- * @param df
- *  The data frame to update.
- * @param idx
- *  A pointer to the row index of the new entry. This is updated from within
- *  the function.
- * @param analysis
- *  The AOI analysis entry to add.
+ * @param ptr
+ *  The external pointer structure pointing to the gac handler whose
+ *  configuration is shared.
+ * @return
+ *  An external pointer structure which points to the new gac handler.
  */
-void gar_analysis_frame_update( SEXP df, uint32_t* idx,
-        gac_aoi_collection_analysis_result_t* analysis );
+SEXP gar_clone( SEXP ptr );
 
 /**
  * Allocate the gac handler.
@@ -143,62 +181,83 @@ SEXP gar_destroy_aoi( SEXP ptr );
 SEXP gar_filter_parameter_create( gac_filter_parameter_t* params );
 
 /**
- * Create a data frame container to hold fixations.
+ * Append a factor column named `group` to a data frame. The rows of the data
+ * frame are expected to be ordered by group.
  *
- * @param count
- *  A preliminary count of items to be added to the data frame.
+ * @param df
+ *  The data frame to extend.
+ * @param counts
+ *  The number of rows of each group.
+ * @param group_count
+ *  The number of groups.
+ * @param levels
+ *  The group names.
  * @return
- *  The data frame.
+ *  The extended data frame.
  */
-SEXP gar_fixation_frame_create( uint32_t count );
+SEXP gar_frame_group_add( SEXP df, uint32_t* counts, uint32_t group_count,
+        SEXP levels );
 
 /**
- * Resize the fixation data frame.
+ * Finalise a chunked parse started with gar_parse_chunk(). The AOI analysis
+ * of the ongoing trial is completed and returned.
  *
- * @param df
- *  The data frame to rezise.
- * @param new_length
- *  The ne length of the data frame
+ * @param ptr
+ *  An external pointer structure pointing to the gac handler.
+ * @param factors
+ *  If TRUE the label columns of the result are factors, otherwise they are
+ *  character vectors.
+ * @return
+ *  A named list holding the fixation, saccade, and AOI analysis data frames.
  */
-void gar_fixation_frame_resize( SEXP df, uint32_t new_length );
+SEXP gar_flush( SEXP ptr, SEXP factors );
 
 /**
- * Release the protection of the fixation data frame.
+ * Return the current parameter of the gac handler.
  *
- * @param df
- *  The data frame to unprotect.
+ * @param ptr
+ *  An external pointer structure pointing to the gac handler.
+ * @return
+ *  A named list holding the filter parameter values.
  */
-void gar_fixation_frame_unprotect( SEXP df );
+SEXP gar_get_filter_parameter( SEXP ptr );
 
 /**
- * Add a new entry to the fixation data frame.
+ * Return the default filter parameters.
  *
- * @param df
- *  The data frame to update.
- * @param idx
- *  The row index of the new entry.
- * @param fixation
- *  The fixation entry to add.
+ * @return
+ *  A named list holding the default filter parameter values.
  */
-void gar_fixation_frame_update( SEXP df, uint32_t idx, gac_fixation_t* fixation );
+SEXP gar_get_filter_parameter_default();
 
 /**
- * Return the current parameter of the gac handler.
+ * Return the latencies from sample arrival to event emission of the samples
+ * pushed with gar_push(). The arrival time of a sample is the time the
+ * gar_push() call holding the sample was entered.
  *
  * @param ptr
  *  An external pointer structure pointing to the gac handler.
+ * @param reset
+ *  If TRUE the latency histogram is cleared after it was read.
  * @return
- *  A named list holding the filter parameter values.
+ *  A named list holding a named summary vector (count, mean, p50, p90, p99,
+ *  max) and a data frame with the non-empty histogram bins. All latencies
+ *  are in milliseconds.
  */
-SEXP gar_get_filter_parameter( SEXP ptr );
+SEXP gar_get_latency( SEXP ptr, SEXP reset );
 
 /**
- * Return the default filter parameters.
+ * Return the parser statistics accumulated by the handler since it was
+ * created or since the last call to gar_reset_stats(). An R error is raised
+ * if the package was built without GAR_STATS.
  *
+ * @param ptr
+ *  An external pointer structure pointing to the gac handler.
  * @return
- *  A named list holding the default filter parameter values.
+ *  A named numeric vector holding the counters and the per-stage times in
+ *  seconds.
  */
-SEXP gar_get_filter_parameter_default();
+SEXP gar_get_stats( SEXP ptr );
 
 /**
  * Initialize the gac type tag. It is initialized by calling the C level
@@ -209,6 +268,46 @@ SEXP gar_get_filter_parameter_default();
  */
 SEXP gar_init( void );
 
+/**
+ * Intern a range of R labels and store their label IDs. Consecutive samples
+ * with the same label are only interned once.
+ *
+ * @param label
+ *  The R character vector holding the labels.
+ * @param offset
+ *  The index of the first label to intern.
+ * @param count
+ *  The number of labels to intern.
+ * @param ids
+ *  The list where the label IDs are stored. It must hold `count` elements.
+ * @param labels
+ *  A pointer to the label dictionary.
+ * @return
+ *  True on success, false on failure.
+ */
+bool gar_label_ids_create( SEXP label, uint32_t offset, uint32_t count,
+        uint32_t* ids, gar_labels_t* labels );
+
+/**
+ * Create an R character vector holding all labels of a label dictionary.
+ *
+ * @param labels
+ *  A pointer to the label dictionary.
+ * @return
+ *  The character vector where the index corresponds to the label ID.
+ */
+SEXP gar_label_levels_create( gar_labels_t* labels );
+
+/**
+ * Release a label dictionary held by an external pointer. This is the
+ * finaliser of the pointer and may also be called directly; the pointer is
+ * cleared such that the dictionary is only released once.
+ *
+ * @param ptr
+ *  The external pointer to a label dictionary allocated with malloc().
+ */
+void gar_labels_finalise( SEXP ptr );
+
 /**
  * Search for fixations and saccades in a set of data samples.
  * The sample data is passed as several vectors where each must have the same
@@ -238,12 +337,461 @@ SEXP gar_init( void );
  *  The ID of the current trial.
  * @param label
  *  An arbitary label annotating the data.
+ * @param factors
+ *  If TRUE the label columns of the result are factors, otherwise they are
+ *  character vectors.
+ * @param stages
+ *  The number of pipeline stages which run on their own thread (1 to
+ *  GAR_PIPELINE_STAGE_COUNT). With 1 stage, all samples are parsed on the
+ *  calling thread.
  * @return
  *  A named list holding two data frames, one holding fixations and one holding
  *  saccades.
  */
 SEXP gar_parse( SEXP ptr, SEXP px, SEXP py, SEXP pz, SEXP ox, SEXP oy, SEXP oz,
-        SEXP sx, SEXP sy, SEXP timestamp, SEXP trial_id, SEXP label );
+        SEXP sx, SEXP sy, SEXP timestamp, SEXP trial_id, SEXP label,
+        SEXP factors, SEXP stages );
+
+/**
+ * Search for fixations and saccades in a chunk of a continuous recording.
+ * In contrast to gar_parse(), the AOI analysis is not finalised such that
+ * fixations and AOI trials may span several chunks. Only the events which
+ * were completed within the chunk are returned. Call gar_flush() after the
+ * last chunk.
+ *
+ * The label dictionary is kept in the handler across chunks. If the label
+ * columns are factors, the levels hold all labels seen so far.
+ *
+ * @param ptr
+ *  An external pointer structure pointing to the gac handler.
+ * @param px
+ *  A vector holding the x coordinates of the gaze point.
+ * @param py
+ *  A vector holding the y coordinates of the gaze point.
+ * @param pz
+ *  A vector holding the z coordinates of the gaze point.
+ * @param ox
+ *  A vector holding the x coordinates of the gaze origin.
+ * @param oy
+ *  A vector holding the y coordinates of the gaze origin.
+ * @param oz
+ *  A vector holding the z coordinates of the gaze origin.
+ * @param sx
+ *  A vector holding the x coordinates of the gaze screen point.
+ * @param sy
+ *  A vector holding the y coordinates of the gaze screen point.
+ * @param timestamp
+ *  A vector holding the relative timestamps of the samples.
+ * @param trial_id
+ *  The ID of the current trial.
+ * @param label
+ *  An arbitary label annotating the data.
+ * @param factors
+ *  If TRUE the label columns of the result are factors, otherwise they are
+ *  character vectors.
+ * @return
+ *  A named list holding the fixation, saccade, and AOI analysis data frames.
+ */
+SEXP gar_parse_chunk( SEXP ptr, SEXP px, SEXP py, SEXP pz, SEXP ox, SEXP oy,
+        SEXP oz, SEXP sx, SEXP sy, SEXP timestamp, SEXP trial_id, SEXP label,
+        SEXP factors );
+
+/**
+ * Search for fixations and saccades in the gaze samples of a CSV file. The
+ * file is memory-mapped and read in blocks which are passed to the parser
+ * directly. Samples where one of the validity flags is not true are skipped.
+ *
+ * @param ptr
+ *  An external pointer structure pointing to the gac handler.
+ * @param path
+ *  The path to the CSV file.
+ * @param screen
+ *  If TRUE the screen point columns sx and sy are passed to the parser,
+ *  otherwise the screen points are computed from the configured screen.
+ * @param factors
+ *  If TRUE the label columns of the result are factors, otherwise they are
+ *  character vectors.
+ * @return
+ *  A named list holding the fixation, saccade, and AOI analysis data frames.
+ */
+SEXP gar_parse_csv( SEXP ptr, SEXP path, SEXP screen, SEXP factors );
+
+/**
+ * Search for fixations and saccades in a set of data samples which consist
+ * of independent groups (e.g. participants or sessions). The groups are
+ * parsed in parallel where each group is parsed by a new gac handler which
+ * is configured like the gac handler of `ptr`. The results are concatenated
+ * in the order of the group levels.
+ *
+ * @param ptr
+ *  An external pointer structure pointing to the gac handler.
+ * @param px
+ *  A vector holding the x coordinates of the gaze point.
+ * @param py
+ *  A vector holding the y coordinates of the gaze point.
+ * @param pz
+ *  A vector holding the z coordinates of the gaze point.
+ * @param ox
+ *  A vector holding the x coordinates of the gaze origin.
+ * @param oy
+ *  A vector holding the y coordinates of the gaze origin.
+ * @param oz
+ *  A vector holding the z coordinates of the gaze origin.
+ * @param sx
+ *  A vector holding the x coordinates of the gaze screen point.
+ * @param sy
+ *  A vector holding the y coordinates of the gaze screen point.
+ * @param timestamp
+ *  A vector holding the relative timestamps of the samples.
+ * @param trial_id
+ *  The ID of the current trial.
+ * @param label
+ *  An arbitary label annotating the data.
+ * @param group
+ *  A factor assigning each sample to a group. Samples with a missing group
+ *  are ignored.
+ * @param threads
+ *  The number of worker threads. If zero, one thread per processor is used.
+ * @param factors
+ *  If TRUE the label columns of the result are factors, otherwise they are
+ *  character vectors.
+ * @return
+ *  A named list holding the fixation, saccade, and AOI analysis data frames
+ *  where each data frame has an additional group column.
+ */
+SEXP gar_parse_grouped( SEXP ptr, SEXP px, SEXP py, SEXP pz, SEXP ox, SEXP oy,
+        SEXP oz, SEXP sx, SEXP sy, SEXP timestamp, SEXP trial_id, SEXP label,
+        SEXP group, SEXP threads, SEXP factors );
+
+/**
+ * Parse gaze data with a set of filter configurations. Each configuration is
+ * evaluated in parallel by a new gac handler which holds the screen and AOIs
+ * of `ptr` and the filter parameters of `ptr` where the thresholds are
+ * replaced by the values of the configuration. Only a summary of the
+ * detected events is kept per configuration.
+ *
+ * @param ptr
+ *  An external pointer structure pointing to the gac handler.
+ * @param px
+ *  A vector holding the x coordinates of the gaze point.
+ * @param py
+ *  A vector holding the y coordinates of the gaze point.
+ * @param pz
+ *  A vector holding the z coordinates of the gaze point.
+ * @param ox
+ *  A vector holding the x coordinates of the gaze origin.
+ * @param oy
+ *  A vector holding the y coordinates of the gaze origin.
+ * @param oz
+ *  A vector holding the z coordinates of the gaze origin.
+ * @param sx
+ *  A vector holding the x coordinates of the gaze screen point.
+ * @param sy
+ *  A vector holding the y coordinates of the gaze screen point.
+ * @param timestamp
+ *  A vector holding the relative timestamps of the samples.
+ * @param trial_id
+ *  The ID of the current trial.
+ * @param label
+ *  An arbitary label annotating the data.
+ * @param velocity_threshold
+ *  The saccade velocity thresholds, one per configuration, or NULL to use
+ *  the threshold of `ptr` in all configurations.
+ * @param duration_threshold
+ *  The fixation duration thresholds, one per configuration, or NULL to use
+ *  the threshold of `ptr` in all configurations.
+ * @param dispersion_threshold
+ *  The fixation dispersion thresholds, one per configuration, or NULL to use
+ *  the threshold of `ptr` in all configurations.
+ * @param threads
+ *  The number of worker threads. If zero, one thread per processor is used.
+ * @return
+ *  A data frame with one row per configuration holding the event counts and
+ *  the mean event durations.
+ */
+SEXP gar_parse_sweep( SEXP ptr, SEXP px, SEXP py, SEXP pz, SEXP ox, SEXP oy,
+        SEXP oz, SEXP sx, SEXP sy, SEXP timestamp, SEXP trial_id, SEXP label,
+        SEXP velocity_threshold, SEXP duration_threshold,
+        SEXP dispersion_threshold, SEXP threads );
+
+/**
+ * Parse a single recording in parallel. The recording is split into blocks
+ * of consecutive trials at trial ID changes and each block is parsed by a
+ * new gac handler which holds the filter parameters, screen, and AOIs of
+ * `ptr`. The samples within the margin around a block are parsed along with
+ * the block to fill the sample window. The block results are concatenated in
+ * timestamp order.
+ *
+ * @param ptr
+ *  An external pointer structure pointing to the gac handler.
+ * @param px
+ *  A vector holding the x coordinates of the gaze point.
+ * @param py
+ *  A vector holding the y coordinates of the gaze point.
+ * @param pz
+ *  A vector holding the z coordinates of the gaze point.
+ * @param ox
+ *  A vector holding the x coordinates of the gaze origin.
+ * @param oy
+ *  A vector holding the y coordinates of the gaze origin.
+ * @param oz
+ *  A vector holding the z coordinates of the gaze origin.
+ * @param sx
+ *  A vector holding the x coordinates of the gaze screen point.
+ * @param sy
+ *  A vector holding the y coordinates of the gaze screen point.
+ * @param timestamp
+ *  A vector holding the relative timestamps of the samples.
+ * @param trial_id
+ *  The ID of the current trial.
+ * @param label
+ *  An arbitary label annotating the data.
+ * @param threads
+ *  The number of worker threads. If zero, one thread per processor is used.
+ * @param margin
+ *  The time in milliseconds before and after each block of which the
+ *  samples are parsed along with the block.
+ * @param factors
+ *  If TRUE the label columns of the result are factors, otherwise they are
+ *  character vectors.
+ * @return
+ *  A named list holding the fixation, saccade, and AOI analysis data frames.
+ */
+SEXP gar_parse_trials( SEXP ptr, SEXP px, SEXP py, SEXP pz, SEXP ox, SEXP oy,
+        SEXP oz, SEXP sx, SEXP sy, SEXP timestamp, SEXP trial_id, SEXP label,
+        SEXP threads, SEXP margin, SEXP factors );
+
+/**
+ * Return all events detected from the samples pushed with gar_push() since
+ * the last poll and remove them from the handler.
+ *
+ * @param ptr
+ *  An external pointer structure pointing to the gac handler.
+ * @param flush
+ *  If TRUE the AOI analysis of the ongoing trial is completed first.
+ * @param factors
+ *  If TRUE the label columns of the result are factors, otherwise they are
+ *  character vectors.
+ * @return
+ *  A named list holding the fixation, saccade, and AOI analysis data frames.
+ */
+SEXP gar_poll( SEXP ptr, SEXP flush, SEXP factors );
+
+/**
+ * Project gaze samples onto the screen configured with gar_set_screen()
+ * without running any filter. Each gaze ray from the gaze origin through the
+ * gaze point is intersected with the screen plane.
+ *
+ * @param ptr
+ *  An external pointer structure pointing to the gac handler.
+ * @param px
+ *  A vector holding the x coordinates of the gaze point.
+ * @param py
+ *  A vector holding the y coordinates of the gaze point.
+ * @param pz
+ *  A vector holding the z coordinates of the gaze point.
+ * @param ox
+ *  A vector holding the x coordinates of the gaze origin.
+ * @param oy
+ *  A vector holding the y coordinates of the gaze origin.
+ * @param oz
+ *  A vector holding the z coordinates of the gaze origin.
+ * @return
+ *  A data frame holding the normalised screen coordinates `sx` and `sy`.
+ */
+SEXP gar_project_screen( SEXP ptr, SEXP px, SEXP py, SEXP pz, SEXP ox,
+        SEXP oy, SEXP oz );
+
+/**
+ * Push samples of a live stream to the online parser of the handler. The
+ * samples are passed to the gac handler one by one and each completed event
+ * is buffered in the handler until it is polled with gar_poll(). The
+ * latency of each event is recorded (see gar_get_latency()). The parser
+ * state is independent of gar_parse_chunk() but both use the same gac
+ * handler, hence they must not be mixed.
+ *
+ * @param ptr
+ *  An external pointer structure pointing to the gac handler.
+ * @param px
+ *  A vector holding the x coordinates of the gaze point.
+ * @param py
+ *  A vector holding the y coordinates of the gaze point.
+ * @param pz
+ *  A vector holding the z coordinates of the gaze point.
+ * @param ox
+ *  A vector holding the x coordinates of the gaze origin.
+ * @param oy
+ *  A vector holding the y coordinates of the gaze origin.
+ * @param oz
+ *  A vector holding the z coordinates of the gaze origin.
+ * @param sx
+ *  A vector holding the x coordinates of the gaze screen point.
+ * @param sy
+ *  A vector holding the y coordinates of the gaze screen point.
+ * @param timestamp
+ *  A vector holding the relative timestamps of the samples.
+ * @param trial_id
+ *  The ID of the current trial.
+ * @param label
+ *  An arbitary label annotating the data.
+ * @return
+ *  R_NilValue
+ */
+SEXP gar_push( SEXP ptr, SEXP px, SEXP py, SEXP pz, SEXP ox, SEXP oy,
+        SEXP oz, SEXP sx, SEXP sy, SEXP timestamp, SEXP trial_id, SEXP label );
+
+/**
+ * Reset the parser statistics of the handler.
+ *
+ * @param ptr
+ *  An external pointer structure pointing to the gac handler.
+ * @return
+ *  R_NilValue
+ */
+SEXP gar_reset_stats( SEXP ptr );
+
+/**
+ * Create the result list of a parse run from a list of detected events. The
+ * events are copied and the columns of the data frames are lazy ALTREP
+ * vectors reading from the copy (see gar_frame_fixations_create()).
+ *
+ * @param events
+ *  A pointer to the list of detected events.
+ * @param has_aoi
+ *  True if the AOI analysis data frame is to be added, false otherwise.
+ * @param factor
+ *  True if the label and AOI name columns are to be created as factors, false
+ *  if they are to be created as character vectors.
+ * @return
+ *  A named list holding the fixation, saccade, and AOI analysis data frames.
+ */
+SEXP gar_result_create( gar_events_t* events, bool has_aoi, bool factor );
+
+/**
+ * Let a batch point to the complete sample columns of R vectors.
+ *
+ * @param batch
+ *  A pointer to the batch to update. The label fields are cleared.
+ * @param px
+ *  A vector holding the x coordinates of the gaze point.
+ * @param py
+ *  A vector holding the y coordinates of the gaze point.
+ * @param pz
+ *  A vector holding the z coordinates of the gaze point.
+ * @param ox
+ *  A vector holding the x coordinates of the gaze origin.
+ * @param oy
+ *  A vector holding the y coordinates of the gaze origin.
+ * @param oz
+ *  A vector holding the z coordinates of the gaze origin.
+ * @param sx
+ *  An optional vector holding the x coordinates of the gaze screen point.
+ * @param sy
+ *  An optional vector holding the y coordinates of the gaze screen point.
+ * @param timestamp
+ *  A vector holding the relative timestamps of the samples.
+ * @param trial_id
+ *  A vector holding the trial IDs.
+ */
+void gar_samples_attach( gar_batch_t* batch, SEXP px, SEXP py, SEXP pz,
+        SEXP ox, SEXP oy, SEXP oz, SEXP sx, SEXP sy, SEXP timestamp,
+        SEXP trial_id );
+
+/**
+ * Check the type and length of the sample vectors. An R error is raised if
+ * the check fails.
+ *
+ * @param px
+ *  A vector holding the x coordinates of the gaze point.
+ * @param py
+ *  A vector holding the y coordinates of the gaze point.
+ * @param pz
+ *  A vector holding the z coordinates of the gaze point.
+ * @param ox
+ *  A vector holding the x coordinates of the gaze origin.
+ * @param oy
+ *  A vector holding the y coordinates of the gaze origin.
+ * @param oz
+ *  A vector holding the z coordinates of the gaze origin.
+ * @param sx
+ *  An optional vector holding the x coordinates of the gaze screen point.
+ * @param sy
+ *  An optional vector holding the y coordinates of the gaze screen point.
+ * @param timestamp
+ *  A vector holding the relative timestamps of the samples.
+ * @param trial_id
+ *  A vector holding the trial IDs.
+ * @param label
+ *  A vector holding the sample labels.
+ * @return
+ *  The number of samples.
+ */
+uint32_t gar_samples_check( SEXP px, SEXP py, SEXP pz, SEXP ox, SEXP oy,
+        SEXP oz, SEXP sx, SEXP sy, SEXP timestamp, SEXP trial_id, SEXP label );
+
+/**
+ * Intern the labels of a range of samples (see gar_pipeline_ingest_t).
+ *
+ * @param data
+ *  The vector holding the sample labels.
+ * @param offset
+ *  The index of the first sample of the range.
+ * @param count
+ *  The number of samples of the range.
+ * @param ids
+ *  The destination of the label IDs of the range.
+ * @param labels
+ *  The label dictionary to intern the labels into.
+ * @return
+ *  True on success, false on failure.
+ */
+bool gar_samples_ingest( void* data, uint32_t offset, uint32_t count,
+        uint32_t* ids, gar_labels_t* labels );
+
+/**
+ * Feed the samples of R vectors block-wise to the parser. The AOI analysis is
+ * not finalised. The labels are interned into the label dictionary of the
+ * event list. With more than one stage, the work is split into pipeline
+ * stages on their own threads (see gar_pipeline_parse()).
+ *
+ * @param h
+ *  A pointer to the handler. If `sx` and `sy` are NULL, the screen points
+ *  are computed with the screen of the handler.
+ * @param events
+ *  A pointer to the event list to append the detected events to.
+ * @param px
+ *  A vector holding the x coordinates of the gaze point.
+ * @param py
+ *  A vector holding the y coordinates of the gaze point.
+ * @param pz
+ *  A vector holding the z coordinates of the gaze point.
+ * @param ox
+ *  A vector holding the x coordinates of the gaze origin.
+ * @param oy
+ *  A vector holding the y coordinates of the gaze origin.
+ * @param oz
+ *  A vector holding the z coordinates of the gaze origin.
+ * @param sx
+ *  An optional vector holding the x coordinates of the gaze screen point.
+ * @param sy
+ *  An optional vector holding the y coordinates of the gaze screen point.
+ * @param timestamp
+ *  A vector holding the relative timestamps of the samples.
+ * @param trial_id
+ *  A vector holding the trial IDs.
+ * @param label
+ *  A vector holding the sample labels.
+ * @param len
+ *  The number of samples as returned by gar_samples_check().
+ * @param stage_count
+ *  The number of pipeline stages which run on their own thread.
+ * @return
+ *  True on success, false on failure.
+ */
+bool gar_samples_parse( gar_handler_t* h, gar_events_t* events, SEXP px,
+        SEXP py, SEXP pz, SEXP ox, SEXP oy, SEXP oz, SEXP sx, SEXP sy,
+        SEXP timestamp, SEXP trial_id, SEXP label, uint32_t len,
+        uint32_t stage_count );
 
 /**
  * Configure the screen position in 3d space. This allows to compute 2d
@@ -269,50 +817,63 @@ SEXP gar_parse( SEXP ptr, SEXP px, SEXP py, SEXP pz, SEXP ox, SEXP oy, SEXP oz,
  *  The y coordinate of the bottom left screen corner.
  * @param bottom_left_z
  *  The z coordinate of the bottom left screen corner.
+ * @param project
+ *  If TRUE the screen points are computed block-wise by the wrapper,
+ *  otherwise libgac computes them per sample.
  * @return
  *  R_NilValue
  */
 SEXP gar_set_screen( SEXP ptr,
         SEXP top_left_x, SEXP top_left_y, SEXP top_left_z,
         SEXP top_right_x, SEXP top_right_y, SEXP top_right_z,
-        SEXP bottom_left_x, SEXP bottom_left_y, SEXP bottom_left_z );
-
-/**
- * Create a data frame container to hold saccades.
- *
- * @param count
- *  A preliminary count of items to be added to the data frame.
- * @return
- *  The data frame.
- */
-SEXP gar_saccade_frame_create( uint32_t count );
+        SEXP bottom_left_x, SEXP bottom_left_y, SEXP bottom_left_z,
+        SEXP project );
 
 /**
- * Resize the saccade data frame.
+ * Initialise the configuration of the synthetic gaze generator from R
+ * values. The remaining fields are set to their default values. An R error
+ * is raised if the sample rate is invalid.
  *
- * @param df
- *  The data frame to rezise.
- * @param new_length
- *  The ne length of the data frame
+ * @param params
+ *  A pointer to the configuration to initialise.
+ * @param rate
+ *  The sample rate in Hz.
+ * @param gap_rate
+ *  The probability of a gap (blink or tracking loss) after a fixation.
+ * @param nan_rate
+ *  The fraction of samples where all coordinates are NaN.
+ * @param trial_duration
+ *  The duration of a trial in milliseconds.
+ * @param label_duration
+ *  The duration of a label in milliseconds.
+ * @param seed
+ *  The seed of the random number generator.
  */
-void gar_saccade_frame_resize( SEXP df, uint32_t new_length );
+void gar_synth_parameter_parse( gar_synth_parameter_t* params, SEXP rate,
+        SEXP gap_rate, SEXP nan_rate, SEXP trial_duration,
+        SEXP label_duration, SEXP seed );
 
 /**
- * Release the protection of the saccade data frame.
+ * Generate a synthetic gaze stream with fixations, saccades, gaps, trial
+ * changes, and label changes.
  *
- * @param df
- *  The data frame to unprotect.
+ * @param n
+ *  The number of samples to generate.
+ * @param rate
+ *  The sample rate in Hz.
+ * @param gap_rate
+ *  The probability of a gap (blink or tracking loss) after a fixation.
+ * @param nan_rate
+ *  The fraction of samples where all coordinates are NaN.
+ * @param trial_duration
+ *  The duration of a trial in milliseconds.
+ * @param label_duration
+ *  The duration of a label in milliseconds.
+ * @param seed
+ *  The seed of the random number generator.
+ * @return
+ *  A data frame with the sample columns of the `gaze` data set.
  */
-void gar_saccade_frame_unprotect( SEXP df );
+SEXP gar_synthesise( SEXP n, SEXP rate, SEXP gap_rate, SEXP nan_rate,
+        SEXP trial_duration, SEXP label_duration, SEXP seed );
 
-/**
- * Add a new entry to the saccade data frame.
- *
- * @param df
- *  The data frame to update.
- * @param idx
- *  The row index of the new entry.
- * @param saccade
- *  The saccade entry to add.
- */
-void gar_saccade_frame_update( SEXP df, uint32_t idx, gac_saccade_t* saccade );